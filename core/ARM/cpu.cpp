@@ -0,0 +1,66 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include "cpu.h"
+#include "Base/Assert.h"
+#include "Base/Thread.h"
+#include "memory/host_memory.h"
+
+CPU::CPU() {
+    // Shared memory objects are zero filled
+    physical = Memory::physical_memory_create(MEM_SIZE);
+    ASSERT_MSG(physical.linear != nullptr, "Failed to allocate guest memory");
+
+    fastmem = Memory::view_reserve(MEM_SIZE);
+    if (fastmem.base != nullptr &&
+        Memory::view_map(&fastmem, 0, &physical, 0, MEM_SIZE, HOST_PROT_READ | HOST_PROT_WRITE)) {
+        memory = fastmem.base;
+    } else {
+        LOG_WARNING(ARM, "Guest memory views are unavailable, using the linear view");
+        Memory::view_release(&fastmem);
+        memory = physical.linear;
+    }
+}
+
+CPU::~CPU() {
+    Memory::view_release(&fastmem);
+    Memory::physical_memory_destroy(&physical);
+}
+
+bool CPU::bind_to_numa_node(s32 node) {
+    // The policy belongs to the shared memory object, so it covers every view of it
+    return Base::BindMemoryToNumaNode(physical.linear, physical.size, node);
+}
+
+// Guest memory is a single linear allocation, so after the per-page hooks have run every block
+// operation is one memcpy/memset, no matter how many pages it spans.
+
+void CPU::read_block(u64 addr, void* dest, size_t size) {
+    if (size == 0 || !check_range(addr, size)) {
+        return;
+    }
+    std::memcpy(dest, &memory[addr], size);
+}
+
+void CPU::write_block(u64 addr, const void* src, size_t size) {
+    if (size == 0 || !check_range(addr, size)) {
+        return;
+    }
+    prepare_write(addr, size);
+    std::memcpy(&memory[addr], src, size);
+}
+
+void CPU::zero_block(u64 addr, size_t size) {
+    if (size == 0 || !check_range(addr, size)) {
+        return;
+    }
+    prepare_write(addr, size);
+    std::memset(&memory[addr], 0, size);
+}
+
+void CPU::copy_block(u64 dest_addr, u64 src_addr, size_t size) {
+    if (size == 0 || !check_range(dest_addr, size) || !check_range(src_addr, size)) {
+        return;
+    }
+    prepare_write(dest_addr, size);
+    std::memmove(&memory[dest_addr], &memory[src_addr], size);
+}
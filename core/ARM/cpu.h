@@ -2,19 +2,46 @@
 
 #pragma once
 
+#include <bitset>
 #include <cstring>
+#include <type_traits>
+#include <vector>
 
 #include "Base/Logging/Log.h"
+#include "memory/dirty_tracker.h"
+#include "memory/physical_memory.h"
+
+class Savestate;
 
 struct CPU {
     u64 regs[31] = {0}; // X0–X30
     u64 pc = 0;
     static constexpr size_t MEM_SIZE = 64 * 1024;
-    u8 memory[MEM_SIZE];
+    static constexpr size_t PAGE_BITS = 12;
+    static constexpr size_t PAGE_SIZE = 1ULL << PAGE_BITS;
+    static constexpr size_t NUM_PAGES = MEM_SIZE / PAGE_SIZE;
+    // Guest RAM, mapped into the fastmem view of the guest address space. `memory` points at
+    // the fastmem view, or at the linear view on hosts without view support.
+    Memory::PhysicalMemory physical = {};
+    Memory::MemoryView fastmem = {};
+    u8* memory = nullptr;
 
-    CPU() {
-        std::memset(memory, 0, MEM_SIZE);
-    }
+    // Pages still shared with at least one live savestate. Anything writing guest memory
+    // must call preserve_page() before modifying one of these (see ARM/savestate.h).
+    std::bitset<NUM_PAGES> cow_pages;
+    std::vector<Savestate*> savestates;
+
+    // Epoch stamps of the last write to each page
+    Memory::DirtyPageTracker dirty_pages{NUM_PAGES, PAGE_BITS};
+
+    CPU();
+    ~CPU();
+
+    CPU(const CPU&) = delete;
+    CPU& operator=(const CPU&) = delete;
+
+    // Moves guest memory to `node` and keeps it there, see Base::BindMemoryToNumaNode.
+    bool bind_to_numa_node(s32 node);
 
     u64& x(int i) {
         return regs[i];
@@ -23,6 +50,7 @@ struct CPU {
     u8 read_byte(u64 addr) {
         if (addr >= MEM_SIZE) {
             LOG_INFO(ARM, "{} out of bounds", addr);
+            return 0;
         }
         return memory[addr];
     }
@@ -30,10 +58,45 @@ struct CPU {
     void write_byte(u64 addr, u8 byte) {
         if (addr >= MEM_SIZE) {
             LOG_INFO(ARM, "{} out of bounds", addr);
+            return;
         }
+        if (cow_pages[addr >> PAGE_BITS]) [[unlikely]] {
+            preserve_page(addr >> PAGE_BITS);
+        }
+        dirty_pages.mark(addr);
         memory[addr] = byte;
     }
 
+    // Copies a page into every savestate still sharing it, defined in ARM/savestate.cpp
+    void preserve_page(size_t page);
+
+    template <typename T>
+    T read(u64 addr) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        if (check_range(addr, sizeof(T))) [[likely]] {
+            std::memcpy(&value, &memory[addr], sizeof(T));
+        }
+        return value;
+    }
+
+    template <typename T>
+    void write(u64 addr, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (!check_range(addr, sizeof(T))) [[unlikely]] {
+            return;
+        }
+        prepare_write(addr, sizeof(T));
+        std::memcpy(&memory[addr], &value, sizeof(T));
+    }
+
+    // Bulk accessors, defined in ARM/cpu.cpp. Out of range requests are logged and ignored.
+    void read_block(u64 addr, void* dest, size_t size);
+    void write_block(u64 addr, const void* src, size_t size);
+    void zero_block(u64 addr, size_t size);
+    // Guest to guest copy, the ranges may overlap.
+    void copy_block(u64 dest_addr, u64 src_addr, size_t size);
+
     void print_debug_information() {
         LOG_INFO(ARM, "PC = {}", pc);
         for (int reg = 0; reg < 32; reg++) {
@@ -41,8 +104,33 @@ struct CPU {
         }
     }
 
+    bool check_range(u64 addr, size_t size) {
+        if (addr >= MEM_SIZE || size > MEM_SIZE - addr) [[unlikely]] {
+            LOG_ERROR(ARM, "Access of {} bytes at {:#x} out of bounds", size, addr);
+            return false;
+        }
+        return true;
+    }
+
+    // Runs the copy-on-write and dirty tracking hooks for every page in the range.
+    void prepare_write(u64 addr, size_t size) {
+        const size_t first = addr >> PAGE_BITS;
+        const size_t last = (addr + size - 1) >> PAGE_BITS;
+        for (size_t page = first; page <= last; ++page) {
+            if (cow_pages[page]) [[unlikely]] {
+                preserve_page(page);
+            }
+        }
+        dirty_pages.mark_range(addr, size);
+    }
+
     void get_state(u64* out_regs, u64& out_pc) const {
         std::memcpy(out_regs, regs, sizeof(regs));
         out_pc = pc;
     }
+
+    void set_state(const u64* in_regs, u64 in_pc) {
+        std::memcpy(regs, in_regs, sizeof(regs));
+        pc = in_pc;
+    }
 };
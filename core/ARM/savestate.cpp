@@ -0,0 +1,51 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include "savestate.h"
+
+#include <algorithm>
+
+void CPU::preserve_page(size_t page) {
+    for (Savestate* state : savestates) {
+        state->preserve(page);
+    }
+    cow_pages.reset(page);
+}
+
+Savestate::Savestate(CPU& cpu) : cpu(cpu) {
+    cpu.get_state(regs, pc);
+    page_data = std::make_unique_for_overwrite<u8[]>(CPU::MEM_SIZE);
+    cpu.savestates.push_back(this);
+    cpu.cow_pages.set();
+}
+
+Savestate::~Savestate() {
+    std::erase(cpu.savestates, this);
+}
+
+void Savestate::preserve(size_t page) {
+    if (preserved_pages[page]) {
+        return;
+    }
+    const size_t offset = page << CPU::PAGE_BITS;
+    std::memcpy(&page_data[offset], &cpu.memory[offset], CPU::PAGE_SIZE);
+    preserved_pages.set(page);
+}
+
+void Savestate::restore() {
+    for (size_t page = 0; page < CPU::NUM_PAGES; ++page) {
+        if (!preserved_pages[page]) {
+            continue;
+        }
+        // Restoring is a write too, other savestates sharing this page need their copy first.
+        if (cpu.cow_pages[page]) {
+            cpu.preserve_page(page);
+        }
+        const size_t offset = page << CPU::PAGE_BITS;
+        std::memcpy(&cpu.memory[offset], &page_data[offset], CPU::PAGE_SIZE);
+        cpu.dirty_pages.mark(offset);
+        cpu.cow_pages.set(page);
+    }
+    // Memory matches the capture again, so every page is shared once more.
+    preserved_pages.reset();
+    cpu.set_state(regs, pc);
+}
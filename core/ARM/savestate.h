@@ -0,0 +1,46 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <bitset>
+#include <memory>
+
+#include "cpu.h"
+
+// Snapshot of the CPU register state and guest memory.
+//
+// Capturing doesn't copy guest memory: every page starts out shared with the live CPU and is
+// only copied into the savestate right before the guest first writes to it (copy-on-write).
+// Restoring therefore only has to copy back the pages written since the capture. Any number
+// of savestates may be alive at once; a page is preserved into each one still sharing it.
+class Savestate {
+public:
+    // Captures the current state of `cpu`. The savestate must not outlive the CPU.
+    explicit Savestate(CPU& cpu);
+    ~Savestate();
+
+    Savestate(const Savestate&) = delete;
+    Savestate& operator=(const Savestate&) = delete;
+
+    // Rolls the CPU back to the captured state. The savestate stays valid and can be
+    // restored again later.
+    void restore();
+
+    // Number of pages copied out of guest memory since the capture (or the last restore).
+    size_t preserved_page_count() const {
+        return preserved_pages.count();
+    }
+
+private:
+    friend struct CPU;
+
+    void preserve(size_t page);
+
+    CPU& cpu;
+    u64 regs[31] = {0};
+    u64 pc = 0;
+    std::bitset<CPU::NUM_PAGES> preserved_pages;
+    // Only the preserved pages of this buffer are ever written, so the host never commits
+    // memory for the rest.
+    std::unique_ptr<u8[]> page_data;
+};
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <type_traits>
+
 #include "PolyfillThread.h"
 
 namespace Base {
@@ -153,44 +157,233 @@ private:
   std::mutex consumer_cv_mutex;
 };
 
+/*
+ * Bounded lock-free multi-producer, single-consumer ring (Vyukov's bounded queue).
+ *
+ * Every slot carries a sequence number telling whose turn it is: producers claim a position with
+ * one CAS on the enqueue index and publish the slot by bumping its sequence, so they never take a
+ * lock. The consumer only sleeps once the ring is empty, and producers only touch the condvar
+ * when it is actually asleep. Producers blocked on a full ring are woken the same way.
+ *
+ * Dequeue positions are claimed with a CAS as well, so that EmplaceOverwrite() can evict the
+ * oldest element from a producer thread while the consumer is draining.
+ */
 template <typename T, size_t Capacity = detail::DefaultCapacity>
 class MPSCQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
 public:
+  MPSCQueue() {
+    for (size_t i = 0; i < Capacity; i++) {
+      slots[i].sequence.store(i, std::memory_order::relaxed);
+    }
+  }
+
   template <typename... Args>
   bool TryEmplace(Args&&... args) {
-    std::scoped_lock lock{writeMutex};
-    return spscQueue.TryEmplace(std::forward<Args>(args)...);
+    return Emplace(std::forward<Args>(args)...);
+  }
+
+  /// Pushes the element, evicting the oldest queued element while the ring is full. `onEvict` is
+  /// called on the evicted element before its slot is reused. Only an element the consumer hasn't
+  /// claimed yet can be evicted: if the consumer is still working on the oldest slot, the new
+  /// element is dropped instead of waiting for it. Returns false if the element was dropped.
+  template <typename Func, typename... Args>
+  bool EmplaceOverwrite(Func&& onEvict, Args&&... args) {
+    while (!Emplace(std::forward<Args>(args)...)) {
+      if (!EvictOldest(onEvict)) {
+        return false;
+      }
+    }
+    return true;
   }
 
   template <typename... Args>
   void EmplaceWait(Args&&... args) {
-    std::scoped_lock lock{writeMutex};
-    spscQueue.EmplaceWait(std::forward<Args>(args)...);
+    while (!Emplace(std::forward<Args>(args)...)) {
+      std::unique_lock lock{producerMutex};
+      waitingProducers.fetch_add(1, std::memory_order::relaxed);
+      std::atomic_thread_fence(std::memory_order::seq_cst);
+      producerCv.wait(lock, [this] { return !IsFull(); });
+      waitingProducers.fetch_sub(1, std::memory_order::relaxed);
+    }
   }
 
   bool TryPop(T& t) {
-    return spscQueue.TryPop(t);
+    return ConsumeBatch([&t](T& value) { t = std::move(value); }, 1) != 0;
   }
 
   bool PopWait(T& t) {
-    return spscQueue.PopWait(t);
+    while (!TryPop(t)) {
+      WaitForData({});
+    }
+    return true;
   }
 
-  bool PopWait(T& t, std::stop_token stop_token) {
-    return spscQueue.PopWait(t, stop_token);
+  bool PopWait(T& t, std::stop_token stopToken) {
+    while (!TryPop(t)) {
+      if (!WaitForData(stopToken)) {
+        return false;
+      }
+    }
+    return true;
   }
 
   T PopWait() {
-    return spscQueue.PopWait();
+    T t;
+    PopWait(t);
+    return t;
   }
 
-  T PopWait(std::stop_token stop_token) {
-    return spscQueue.PopWait(stop_token);
+  T PopWait(std::stop_token stopToken) {
+    T t;
+    PopWait(t, stopToken);
+    return t;
+  }
+
+  /// Calls `func` on up to `maxCount` queued elements in place, in order, without blocking.
+  /// Returns the number of elements consumed.
+  template <typename Func>
+  size_t ConsumeBatch(Func&& func, size_t maxCount) {
+    size_t count = 0;
+    size_t pos = dequeueIndex.load(std::memory_order::relaxed);
+    while (count < maxCount) {
+      Slot &slot = slots[pos % Capacity];
+      const size_t sequence = slot.sequence.load(std::memory_order::acquire);
+      const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos + 1);
+      if (diff < 0) {
+        break;
+      }
+      if (diff > 0) {
+        pos = dequeueIndex.load(std::memory_order::relaxed);
+        continue;
+      }
+      if (!dequeueIndex.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+        continue;
+      }
+      func(slot.value);
+      // Hand the slot back to producers for the next lap around the ring
+      slot.sequence.store(pos + Capacity, std::memory_order::release);
+      ++pos;
+      ++count;
+    }
+    if (count != 0) {
+      std::atomic_thread_fence(std::memory_order::seq_cst);
+      if (waitingProducers.load(std::memory_order::relaxed) != 0) {
+        std::scoped_lock lock{producerMutex};
+        producerCv.notify_all();
+      }
+    }
+    return count;
+  }
+
+  /// Sleeps until the queue is not empty. Returns false if woken by a stop request instead.
+  bool WaitForData(std::stop_token stopToken) {
+    std::unique_lock lock{consumerMutex};
+    consumerSleeping.store(true, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    Base::CondvarWait(consumerCv, lock, stopToken, [this] { return !IsEmpty(); });
+    consumerSleeping.store(false, std::memory_order::relaxed);
+    return !IsEmpty();
+  }
+
+  /// Same as above, but also returns after `timeout` with the queue still empty.
+  template <typename Rep, typename Period>
+  bool WaitForData(std::stop_token stopToken, const std::chrono::duration<Rep, Period> &timeout) {
+    std::unique_lock lock{consumerMutex};
+    consumerSleeping.store(true, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    consumerCv.wait_for(lock, stopToken, timeout, [this] { return !IsEmpty(); });
+    consumerSleeping.store(false, std::memory_order::relaxed);
+    return !IsEmpty();
   }
 
 private:
-  SPSCQueue<T, Capacity> spscQueue;
-  std::mutex writeMutex;
+  struct Slot {
+    std::atomic_size_t sequence;
+    T value;
+  };
+
+  template <typename... Args>
+  bool Emplace(Args&&... args) {
+    size_t pos = enqueueIndex.load(std::memory_order::relaxed);
+    Slot *slot = nullptr;
+    while (true) {
+      slot = &slots[pos % Capacity];
+      const size_t sequence = slot->sequence.load(std::memory_order::acquire);
+      const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueueIndex.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // The consumer hasn't released this slot from the previous lap, the ring is full
+        return false;
+      } else {
+        pos = enqueueIndex.load(std::memory_order::relaxed);
+      }
+    }
+
+    // Assigning instead of constructing lets the slot keep its heap storage between laps
+    if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...)) {
+      slot->value = (std::forward<Args>(args), ...);
+    } else {
+      slot->value = T(std::forward<Args>(args)...);
+    }
+    slot->sequence.store(pos + 1, std::memory_order::release);
+
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (consumerSleeping.load(std::memory_order::relaxed)) {
+      std::scoped_lock lock{consumerMutex};
+      consumerCv.notify_one();
+    }
+    return true;
+  }
+
+  // Frees the slot the next push goes to by evicting the element in it. Returns false if that
+  // slot is held by the consumer, true once the slot is free (whoever freed it).
+  template <typename Func>
+  bool EvictOldest(Func&& onEvict) {
+    const size_t pos = enqueueIndex.load(std::memory_order::relaxed);
+    if (pos < Capacity) {
+      return true;
+    }
+    // The element from the previous lap, evictable only while it is published and unclaimed
+    size_t oldest = pos - Capacity;
+    Slot &slot = slots[oldest % Capacity];
+    if (slot.sequence.load(std::memory_order::acquire) == oldest + 1 &&
+        dequeueIndex.compare_exchange_strong(oldest, oldest + 1, std::memory_order::relaxed)) {
+      onEvict(slot.value);
+      slot.sequence.store(pos, std::memory_order::release);
+      return true;
+    }
+    // Retry only if the slot was released meanwhile. Otherwise it is still being written by a
+    // producer or read by the consumer, and waiting for either is what dropping avoids.
+    const size_t sequence = slot.sequence.load(std::memory_order::acquire);
+    return static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos) >= 0;
+  }
+
+  bool IsEmpty() const {
+    const size_t pos = dequeueIndex.load(std::memory_order::relaxed);
+    return slots[pos % Capacity].sequence.load(std::memory_order::acquire) != pos + 1;
+  }
+
+  bool IsFull() const {
+    const size_t pos = enqueueIndex.load(std::memory_order::relaxed);
+    return slots[pos % Capacity].sequence.load(std::memory_order::acquire) < pos;
+  }
+
+  alignas(128) std::atomic_size_t enqueueIndex{0};
+  alignas(128) std::atomic_size_t dequeueIndex{0};
+  alignas(128) std::atomic_bool consumerSleeping = false;
+  std::atomic_size_t waitingProducers = 0;
+
+  std::array<Slot, Capacity> slots;
+
+  std::condition_variable_any consumerCv;
+  std::mutex consumerMutex;
+  std::condition_variable_any producerCv;
+  std::mutex producerMutex;
 };
 
 template <typename T, size_t Capacity = detail::DefaultCapacity>
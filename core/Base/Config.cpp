@@ -13,8 +13,20 @@ static int heightWindow = 480;
 
 static bool logAdvanced = false;
 
+static bool logBinary = false;
+
 static std::string typeLog = "async";
 
+static LogMode modeLog = LogMode::Async;
+
+static std::string policyLogOverflow = "drop-newest";
+
+static LogOverflow overflowLog = LogOverflow::DropNewest;
+
+static std::string modeHugePages = "off";
+
+static int nodeNuma = -1;
+
 int windowWidth() {
   return widthWindow;
 }
@@ -27,10 +39,30 @@ bool isLogAdvanced() {
   return logAdvanced;
 }
 
+bool isBinaryLog() {
+  return logBinary;
+}
+
 std::string logType() {
   return typeLog;
 }
 
+LogMode logMode() {
+  return modeLog;
+}
+
+LogOverflow logOverflow() {
+  return overflowLog;
+}
+
+std::string hugePages() {
+  return modeHugePages;
+}
+
+int numaNode() {
+  return nodeNuma;
+}
+
 void Load(const std::filesystem::path& path) {
   // If the configuration file does not exist, create it and return
   std::error_code error;
@@ -54,7 +86,19 @@ void Load(const std::filesystem::path& path) {
     heightWindow = toml::find_or<int>(general, "Window Height", 480);
 
     logAdvanced = toml::find_or<bool>(general, "Advanced Log", false);
+    logBinary = toml::find_or<bool>(general, "Binary Log", false);
     typeLog = toml::find_or<std::string>(general, "Log Type", "async");
+    modeLog = typeLog == "async" ? LogMode::Async : LogMode::Sync;
+    policyLogOverflow = toml::find_or<std::string>(general, "Log Overflow", "drop-newest");
+    if (policyLogOverflow == "block") {
+      overflowLog = LogOverflow::Block;
+    } else if (policyLogOverflow == "drop-oldest") {
+      overflowLog = LogOverflow::DropOldest;
+    } else {
+      overflowLog = LogOverflow::DropNewest;
+    }
+    modeHugePages = toml::find_or<std::string>(general, "Huge Pages", "off");
+    nodeNuma = toml::find_or<int>(general, "NUMA Node", -1);
   }
 }
 
@@ -79,7 +123,11 @@ void Save(const std::filesystem::path& path) {
   data["General"]["Window Width"] = widthWindow;
   data["General"]["Window Height"] = heightWindow;
   data["General"]["Advanced Log"] = logAdvanced;
+  data["General"]["Binary Log"] = logBinary;
   data["General"]["Log Type"] = typeLog;
+  data["General"]["Log Overflow"] = policyLogOverflow;
+  data["General"]["Huge Pages"] = modeHugePages;
+  data["General"]["NUMA Node"] = nodeNuma;
 
   std::ofstream file(path, std::ios::binary);
   file << data;
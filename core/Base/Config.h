@@ -15,6 +15,33 @@ int windowHeight();
 
 bool isLogAdvanced();
 
+// Write the log as a compact .plog file instead of text, decoded with PoundLogDecoder.
+bool isBinaryLog();
+
 std::string logType();
 
+enum class LogMode {
+  Async, // Entries are queued and written by the log thread
+  Sync,  // Entries are written by the thread logging them
+};
+
+// logType() parsed once at load, cheap enough to check on every log call.
+LogMode logMode();
+
+enum class LogOverflow {
+  Block,      // The logging thread waits for room in the queue
+  DropNewest, // The entry being logged is discarded
+  DropOldest, // The oldest queued entry is discarded to make room, or the new one while the
+              // log thread is still writing the oldest
+};
+
+// What async logging does when its queue is full, "Log Overflow" in the config.
+LogOverflow logOverflow();
+
+// One of "off", "transparent" or "explicit", see Memory::HugePageMode.
+std::string hugePages();
+
+// NUMA node guest execution and its memory are bound to, -1 leaves placement to the host.
+int numaNode();
+
 } // namespace Config
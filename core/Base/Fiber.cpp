@@ -0,0 +1,238 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include "Fiber.h"
+#include "Arch.h"
+#include "Assert.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif (defined(ARCH_X86_64) || defined(ARCH_AARCH64))
+#define FIBER_USE_ASM 1
+#else
+#ifdef __APPLE__
+#define _XOPEN_SOURCE
+#endif
+#include <ucontext.h>
+#endif
+
+#include <cstring>
+
+#ifdef FIBER_USE_ASM
+
+#ifdef __APPLE__
+#define FIBER_ASM_SYMBOL(name) "_" #name
+#else
+#define FIBER_ASM_SYMBOL(name) #name
+#endif
+
+// Saves the callee-saved registers of the running context on its own stack, stores the resulting
+// stack pointer in `*fromSp`, then restores the context previously saved at `toSp`.
+extern "C" void Pound_SwitchFiberStack(void **fromSp, void *toSp);
+
+#if defined(ARCH_X86_64)
+// System V: rbx, rbp, r12-r15, plus the MXCSR and x87 control words.
+asm(R"(
+  .text
+  .p2align 4
+  .globl )" FIBER_ASM_SYMBOL(Pound_SwitchFiberStack) R"(
+)" FIBER_ASM_SYMBOL(Pound_SwitchFiberStack) R"(:
+  pushq %rbp
+  pushq %rbx
+  pushq %r12
+  pushq %r13
+  pushq %r14
+  pushq %r15
+  subq $8, %rsp
+  stmxcsr (%rsp)
+  fnstcw 4(%rsp)
+  movq %rsp, (%rdi)
+  movq %rsi, %rsp
+  ldmxcsr (%rsp)
+  fldcw 4(%rsp)
+  addq $8, %rsp
+  popq %r15
+  popq %r14
+  popq %r13
+  popq %r12
+  popq %rbx
+  popq %rbp
+  ret
+)");
+#elif defined(ARCH_AARCH64)
+// AAPCS64: x19-x30 and the low halves of v8-v15.
+asm(R"(
+  .text
+  .p2align 4
+  .globl )" FIBER_ASM_SYMBOL(Pound_SwitchFiberStack) R"(
+)" FIBER_ASM_SYMBOL(Pound_SwitchFiberStack) R"(:
+  sub sp, sp, #160
+  stp x19, x20, [sp, #0]
+  stp x21, x22, [sp, #16]
+  stp x23, x24, [sp, #32]
+  stp x25, x26, [sp, #48]
+  stp x27, x28, [sp, #64]
+  stp x29, x30, [sp, #80]
+  stp d8, d9, [sp, #96]
+  stp d10, d11, [sp, #112]
+  stp d12, d13, [sp, #128]
+  stp d14, d15, [sp, #144]
+  mov x2, sp
+  str x2, [x0]
+  mov sp, x1
+  ldp x19, x20, [sp, #0]
+  ldp x21, x22, [sp, #16]
+  ldp x23, x24, [sp, #32]
+  ldp x25, x26, [sp, #48]
+  ldp x27, x28, [sp, #64]
+  ldp x29, x30, [sp, #80]
+  ldp d8, d9, [sp, #96]
+  ldp d10, d11, [sp, #112]
+  ldp d12, d13, [sp, #128]
+  ldp d14, d15, [sp, #144]
+  add sp, sp, #160
+  ret
+)");
+#endif
+
+#endif // FIBER_USE_ASM
+
+namespace Base {
+
+static thread_local Fiber *currentFiber = nullptr;
+
+#if defined(_WIN32)
+
+struct Fiber::Impl {
+  void *handle = nullptr;
+};
+
+Fiber::Fiber(std::function<void()> &&entryPoint_, size_t stackSize) :
+  impl(std::make_unique<Impl>()), entryPoint(std::move(entryPoint_)) {
+  impl->handle = CreateFiber(stackSize, [](void*) { Startup(); }, nullptr);
+  ASSERT_MSG(impl->handle != nullptr, "Failed to create fiber");
+}
+
+Fiber::~Fiber() {
+  if (isThreadFiber) {
+    ConvertFiberToThread();
+  } else if (impl->handle) {
+    DeleteFiber(impl->handle);
+  }
+}
+
+std::unique_ptr<Fiber> Fiber::ThreadToFiber() {
+  std::unique_ptr<Fiber> fiber{ new Fiber() };
+  fiber->impl->handle = ConvertThreadToFiber(nullptr);
+  ASSERT_MSG(fiber->impl->handle != nullptr, "Failed to convert thread to fiber");
+  currentFiber = fiber.get();
+  return fiber;
+}
+
+void Fiber::SwitchContext(Fiber&, Fiber &to) {
+  SwitchToFiber(to.impl->handle);
+}
+
+#elif defined(FIBER_USE_ASM)
+
+struct Fiber::Impl {
+  std::unique_ptr<u8[]> stack = {};
+  void *sp = nullptr;
+};
+
+Fiber::Fiber(std::function<void()> &&entryPoint_, size_t stackSize) :
+  impl(std::make_unique<Impl>()), entryPoint(std::move(entryPoint_)) {
+  impl->stack = std::make_unique_for_overwrite<u8[]>(stackSize);
+  const uptr top = (reinterpret_cast<uptr>(impl->stack.get()) + stackSize) & ~uptr{15};
+  const uptr startup = reinterpret_cast<uptr>(&Fiber::Startup);
+#if defined(ARCH_X86_64)
+  // Frame popped by Pound_SwitchFiberStack: control words, r15-r12, rbx, rbp, return address.
+  // The return address sits 16 bytes below the top so that Startup sees a call-aligned stack.
+  u64 *frame = reinterpret_cast<u64*>(top - 72);
+  std::memset(frame, 0, 72);
+  const u32 mxcsr = 0x1F80;
+  const u16 fpucw = 0x037F;
+  std::memcpy(frame, &mxcsr, sizeof(mxcsr));
+  std::memcpy(reinterpret_cast<u8*>(frame) + 4, &fpucw, sizeof(fpucw));
+  frame[7] = startup;
+#elif defined(ARCH_AARCH64)
+  // Frame popped by Pound_SwitchFiberStack: x19-x28, fp, lr, d8-d15.
+  u64 *frame = reinterpret_cast<u64*>(top - 160);
+  std::memset(frame, 0, 160);
+  frame[11] = startup;
+#endif
+  impl->sp = frame;
+}
+
+Fiber::~Fiber() = default;
+
+std::unique_ptr<Fiber> Fiber::ThreadToFiber() {
+  std::unique_ptr<Fiber> fiber{ new Fiber() };
+  currentFiber = fiber.get();
+  return fiber;
+}
+
+void Fiber::SwitchContext(Fiber &from, Fiber &to) {
+  Pound_SwitchFiberStack(&from.impl->sp, to.impl->sp);
+}
+
+#else
+
+struct Fiber::Impl {
+  ucontext_t context = {};
+  std::unique_ptr<u8[]> stack = {};
+};
+
+Fiber::Fiber(std::function<void()> &&entryPoint_, size_t stackSize) :
+  impl(std::make_unique<Impl>()), entryPoint(std::move(entryPoint_)) {
+  impl->stack = std::make_unique_for_overwrite<u8[]>(stackSize);
+  getcontext(&impl->context);
+  impl->context.uc_stack.ss_sp = impl->stack.get();
+  impl->context.uc_stack.ss_size = stackSize;
+  impl->context.uc_link = nullptr;
+  makecontext(&impl->context, &Fiber::Startup, 0);
+}
+
+Fiber::~Fiber() = default;
+
+std::unique_ptr<Fiber> Fiber::ThreadToFiber() {
+  std::unique_ptr<Fiber> fiber{ new Fiber() };
+  currentFiber = fiber.get();
+  return fiber;
+}
+
+void Fiber::SwitchContext(Fiber &from, Fiber &to) {
+  swapcontext(&from.impl->context, &to.impl->context);
+}
+
+#endif
+
+Fiber::Fiber() :
+  impl(std::make_unique<Impl>()), isThreadFiber(true)
+{}
+
+Fiber *Fiber::Current() {
+  return currentFiber;
+}
+
+void Fiber::YieldTo(Fiber &from, Fiber &to) {
+  DEBUG_ASSERT(&from == currentFiber);
+  DEBUG_ASSERT(!to.finished);
+  to.previous = &from;
+  currentFiber = &to;
+  SwitchContext(from, to);
+}
+
+void Fiber::Startup() {
+  Fiber *self = currentFiber;
+  self->entryPoint();
+  self->finished = true;
+
+  // A fiber can't return into nothing, hand control back to whoever resumed us last.
+  Fiber *previous = self->previous;
+  ASSERT_MSG(previous != nullptr, "Fiber finished without a fiber to return to");
+  currentFiber = previous;
+  SwitchContext(*self, *previous);
+  UNREACHABLE();
+}
+
+} // namespace Base
@@ -0,0 +1,64 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace Base {
+
+/*
+ * A cooperatively scheduled execution context with its own stack.
+ *
+ * Switching between fibers only swaps callee-saved registers and the stack pointer, so it never
+ * enters the kernel. On x86_64 and AArch64 (non-Windows) this is done with a small hand-written
+ * stack switch, on Windows with the native fiber API, and everywhere else with ucontext.
+ *
+ * Every host thread that wants to switch fibers must first convert itself with ThreadToFiber(),
+ * the returned fiber represents the original thread stack.
+ */
+class Fiber {
+public:
+  static constexpr size_t DefaultStackSize = 512 * 1024;
+
+  explicit Fiber(std::function<void()> &&entryPoint, size_t stackSize = DefaultStackSize);
+  ~Fiber();
+
+  Fiber(const Fiber&) = delete;
+  Fiber& operator=(const Fiber&) = delete;
+
+  Fiber(Fiber&&) = delete;
+  Fiber& operator=(Fiber&&) = delete;
+
+  /// Converts the calling host thread into a fiber so it can switch to other fibers.
+  [[nodiscard]] static std::unique_ptr<Fiber> ThreadToFiber();
+
+  /// Suspends `from` (which must be the fiber running on this thread) and resumes `to`.
+  static void YieldTo(Fiber &from, Fiber &to);
+
+  /// Returns the fiber currently running on this thread, or nullptr if the thread wasn't converted.
+  [[nodiscard]] static Fiber *Current();
+
+  /// Returns true once the entry point of this fiber has returned.
+  bool IsFinished() const {
+    return finished;
+  }
+
+private:
+  struct Impl;
+
+  Fiber();
+
+  static void Startup();
+
+  static void SwitchContext(Fiber &from, Fiber &to);
+
+  std::unique_ptr<Impl> impl;
+  std::function<void()> entryPoint = {};
+  // The fiber that last switched to us, resumed when the entry point returns
+  Fiber *previous = nullptr;
+  bool isThreadFiber = false;
+  bool finished = false;
+};
+
+} // namespace Base
@@ -1,16 +1,21 @@
 // Copyright 2025 Xenon Emulator Project. All rights reserved.
 
+#include <algorithm>
+#include <cstring>
 #include <fmt/format.h>
 #include <functional>
-#include <map>
+#include <unordered_map>
 
+#include "Base/Assert.h"
 #include "Base/BoundedQueue.h"
 #include "Base/IoFile.h"
 #include "Base/PathUtil.h"
 #include "Base/StringUtil.h"
 #include "Base/Thread.h"
+#include "Base/Trace.h"
 
 #include "Backend.h"
+#include "BinaryLog.h"
 #include "Log.h"
 #include "LogEntry.h"
 #include "TextFormatter.h"
@@ -20,11 +25,31 @@ namespace Log {
 
 using namespace Base::FS;
 
+using DeferredArgStore = BinaryLog::ArgStore;
+
+// Formats the captured arguments of a deferred entry into its message. The store is reused
+// between entries so that the log thread doesn't allocate its argument list every time.
+static void FormatDeferredEntry(Entry &entry, DeferredArgStore &store) {
+  entry.message.clear();
+  try {
+    const bool valid = BinaryLog::FormatArgs(entry.message, entry.format,
+      std::span<const u8>(entry.args.data.data(), entry.args.size), store);
+    ASSERT_MSG(valid, "Corrupted log argument buffer");
+  } catch (const fmt::format_error &e) {
+    // The caller would have thrown here before formatting moved to the log thread, keep the
+    // thread alive and report the broken callsite instead
+    entry.message = fmt::format("Invalid log format \"{}\": {}", entry.format, e.what());
+  }
+  entry.format = nullptr;
+}
+
 // Base backend with shell functions
 class BaseBackend {
 public:
   virtual ~BaseBackend() = default;
   virtual void Write(const Entry &entry) = 0;
+  /// Called once the log thread has written out a batch of entries
+  virtual void EndBatch() {}
   virtual void Flush() = 0;
 };
 
@@ -39,29 +64,47 @@ public:
   void Write(const Entry &entry) override {
     if (enabled.load(std::memory_order_relaxed)) {
       PrintColoredMessage(entry);
+      if (entry.logLevel >= Level::Error) {
+        std::fflush(stdout);
+      }
     }
   }
 
+  void EndBatch() override {
+    std::fflush(stdout);
+  }
+
   void Flush() override {
-    // stdout shouldn't be buffered
+    std::fflush(stdout);
   }
 
   void SetEnabled(bool enabled_) {
     enabled = enabled_;
   }
 
+  bool IsEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<bool> enabled = true;
 };
 
-// Backend that writes to a file passed into the constructor
+/*
+ * Backend that writes to a file passed into the constructor. Entries are formatted into a large
+ * buffer that is written out once per batch with a single call, instead of going through the
+ * file once per entry. The file itself is only flushed by the log thread timer, for error level
+ * entries and at shutdown.
+ */
 class FileBackend : public BaseBackend {
 public:
   explicit FileBackend(const fs::path &filename)
-    : file(filename, FS::FileAccessMode::Write, FS::FileMode::TextMode)
-  {}
+    : file(filename, FS::FileAccessMode::Write, FS::FileMode::TextMode) {
+    buffer.reserve(BufferSize);
+  }
 
   ~FileBackend() {
+    Flush();
     file.Close();
   }
 
@@ -70,12 +113,15 @@ public:
       return;
     }
 
+    const size_t previousSize = buffer.size();
     if (entry.formatted) {
-      bytesWritten += file.WriteString(FormatLogMessage(entry).append(1, '\n'));
+      FormatLogMessage(entry, buffer);
+      buffer.push_back('\n');
     }
     else {
-      bytesWritten += file.WriteString(entry.message);
+      buffer.append(entry.message);
     }
+    bytesWritten += buffer.size() - previousSize;
 
     // Prevent logs from exceeding a set maximum size in the event that log entries are spammed.
     constexpr u64 writeLimit = 100_MB;
@@ -86,22 +132,211 @@ public:
         // Don't close the file so we can print a stacktrace if necessary
         enabled = false;
       }
-      file.Flush();
+      Flush();
+    } else if (buffer.size() >= BufferSize) {
+      WriteBuffer();
     }
   }
 
+  void EndBatch() override {
+    WriteBuffer();
+  }
+
   void Flush() override {
+    WriteBuffer();
     file.Flush();
   }
 
 private:
+  // Bytes buffered before they are written out, even in the middle of a batch
+  static constexpr size_t BufferSize = 1_MB;
+
+  void WriteBuffer() {
+    if (!buffer.empty()) {
+      file.WriteString(buffer);
+      buffer.clear();
+    }
+  }
+
   Base::FS::IOFile file;
+  std::string buffer;
   std::atomic<bool> enabled = true;
   size_t bytesWritten = 0;
 };
 
+/*
+ * Writes entries to a .plog file (see BinaryLog.h) without formatting them: deferred entries
+ * are stored as their callsite ID and their varint encoded arguments. Must see entries before
+ * the log thread formats them. Buffered and capped the same way as FileBackend.
+ */
+class BinaryFileBackend : public BaseBackend {
+public:
+  explicit BinaryFileBackend(const fs::path &filename)
+    : file(filename, FS::FileAccessMode::Write, FS::FileMode::BinaryMode) {
+    buffer.reserve(BufferSize);
+    buffer.append(BinaryLog::Magic);
+    buffer.push_back(static_cast<char>(BinaryLog::Version));
+    BinaryLog::WriteVarint(buffer, static_cast<u64>(Class::Count));
+    for (size_t i = 0; i < static_cast<size_t>(Class::Count); i++) {
+      BinaryLog::WriteString(buffer, GetLogClassName(static_cast<Class>(i)));
+    }
+    BinaryLog::WriteVarint(buffer, static_cast<u64>(Level::Count));
+    for (size_t i = 0; i < static_cast<size_t>(Level::Count); i++) {
+      BinaryLog::WriteString(buffer, GetLevelName(static_cast<Level>(i)));
+    }
+  }
+
+  ~BinaryFileBackend() {
+    Flush();
+    file.Close();
+  }
+
+  void Write(const Entry &entry) override {
+    if (!enabled) {
+      return;
+    }
+
+    const size_t previousSize = buffer.size();
+    const s64 timestamp = entry.timestamp.count();
+    if (entry.format) {
+      const u64 callsite = GetCallsite(entry);
+      buffer.push_back(static_cast<char>(BinaryLog::RecordType::Message));
+      BinaryLog::WriteSignedVarint(buffer, timestamp - lastTimestamp);
+      buffer.push_back(static_cast<char>(entry.logClass));
+      buffer.push_back(static_cast<char>(entry.logLevel));
+      BinaryLog::WriteVarint(buffer, callsite);
+      // The size goes before the arguments, encode them separately first
+      encodedArgs.clear();
+      BinaryLog::WriteArgs(encodedArgs,
+                           std::span<const u8>(entry.args.data.data(), entry.args.size));
+      BinaryLog::WriteString(buffer, encodedArgs);
+    } else {
+      buffer.push_back(static_cast<char>(BinaryLog::RecordType::Text));
+      BinaryLog::WriteSignedVarint(buffer, timestamp - lastTimestamp);
+      buffer.push_back(static_cast<char>(entry.logClass));
+      buffer.push_back(static_cast<char>(entry.logLevel));
+      buffer.push_back(static_cast<char>(entry.formatted));
+      BinaryLog::WriteString(buffer, entry.message);
+    }
+    lastTimestamp = timestamp;
+    bytesWritten += buffer.size() - previousSize;
+
+    // Same cap as the text log
+    constexpr u64 writeLimit = 100_MB;
+    const bool writeLimitExceeded = bytesWritten > writeLimit;
+    if (entry.logLevel >= Level::Error || writeLimitExceeded) {
+      if (writeLimitExceeded) {
+        enabled = false;
+      }
+      Flush();
+    } else if (buffer.size() >= BufferSize) {
+      WriteBuffer();
+    }
+  }
+
+  void EndBatch() override {
+    WriteBuffer();
+  }
+
+  void Flush() override {
+    WriteBuffer();
+    file.Flush();
+  }
+
+private:
+  static constexpr size_t BufferSize = 1_MB;
+
+  struct CallsiteKey {
+    const char *format;
+    u32 lineNum;
+
+    bool operator==(const CallsiteKey&) const = default;
+  };
+
+  struct CallsiteKeyHash {
+    size_t operator()(const CallsiteKey &key) const {
+      return std::hash<const char*>{}(key.format) ^ (static_cast<size_t>(key.lineNum) << 1);
+    }
+  };
+
+  // Returns the ID of the entry's callsite, writing its definition the first time it is seen.
+  // Keyed on the line as well since identical format literals may be merged by the linker.
+  u64 GetCallsite(const Entry &entry) {
+    const auto [it, inserted] =
+      callsites.try_emplace(CallsiteKey{ entry.format, entry.lineNum }, callsites.size());
+    if (inserted) {
+      buffer.push_back(static_cast<char>(BinaryLog::RecordType::Callsite));
+      BinaryLog::WriteVarint(buffer, it->second);
+      BinaryLog::WriteVarint(buffer, entry.lineNum);
+      BinaryLog::WriteString(buffer, entry.format);
+      BinaryLog::WriteString(buffer, entry.filename ? entry.filename : "");
+      BinaryLog::WriteString(buffer, entry.function ? entry.function : "");
+    }
+    return it->second;
+  }
+
+  void WriteBuffer() {
+    if (!buffer.empty()) {
+      file.WriteString(buffer);
+      buffer.clear();
+    }
+  }
+
+  Base::FS::IOFile file;
+  std::string buffer;
+  std::string encodedArgs;
+  std::unordered_map<CallsiteKey, u64, CallsiteKeyHash> callsites;
+  s64 lastTimestamp = 0;
+  std::atomic<bool> enabled = true;
+  size_t bytesWritten = 0;
+};
+
+/*
+ * Hands formatted entries to an in-process viewer through a lock-free ring. The log thread
+ * only ever tries to push, so a viewer that falls behind (or a hidden GUI) loses entries
+ * instead of stalling logging.
+ */
+class ViewerBackend : public BaseBackend {
+public:
+  void Write(const Entry &entry) override {
+    if (!enabled.load(std::memory_order_relaxed)) {
+      return;
+    }
+    // Assigning reuses the storage of the staging entry and of the ring slot
+    staging.timestamp = entry.timestamp;
+    staging.logClass = entry.logClass;
+    staging.logLevel = entry.logLevel;
+    staging.message = entry.message;
+    ring.TryEmplace(staging);
+  }
+
+  void Flush() override {}
+
+  void SetEnabled(bool enabled_) {
+    enabled = enabled_;
+  }
+
+  bool IsEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  size_t Read(const std::function<void(ViewerEntry&)> &func, size_t maxCount) {
+    return ring.ConsumeBatch(func, maxCount);
+  }
+
+private:
+  static constexpr size_t RingSize = 0x4000;
+
+  MPSCQueue<ViewerEntry, RingSize> ring;
+  ViewerEntry staging;
+  std::atomic<bool> enabled = false;
+};
+
 bool currentlyInitialising = true;
 
+// Callsites with suppressed messages, reported and reset by the log thread
+static std::atomic<CallsiteLimiter*> limitedCallsites = nullptr;
+
 // Static state as a singleton.
 class Impl {
 public:
@@ -122,6 +357,8 @@ public:
     //filter.ParseFilterString(Config::getLogFilter());
     instance = std::unique_ptr<Impl, decltype(&Deleter)>(new Impl(logDir / logFile, filter), Deleter);
     currentlyInitialising = false;
+    // Old logs are cleaned up off the startup path
+    instance->StartCleanupThread(logDir, logDir / logFile);
   }
 
   static bool IsActive() {
@@ -144,67 +381,58 @@ public:
 
   void SetGlobalFilter(const Filter& f) {
     filter = f;
+    for (size_t i = 0; i < classMinLevels.size(); i++) {
+      classMinLevels[i].store(static_cast<u8>(f.GetClassLevel(static_cast<Class>(i))),
+                              std::memory_order_relaxed);
+    }
   }
 
   void SetColorConsoleBackendEnabled(bool enabled) {
     colorConsoleBackend->SetEnabled(enabled);
   }
 
-  void PushEntry(Class logClass, Level logLevel, const char *filename, u32 lineNum,
-           const char *function, const std::string &message) {
+  void SetViewerEnabled(bool enabled) {
+    viewerBackend->SetEnabled(enabled);
+  }
 
-    if (!filter.CheckMessage(logClass, logLevel)) {
-      return;
-    }
+  size_t ReadViewerEntries(const std::function<void(ViewerEntry&)> &func, size_t maxCount) {
+    return viewerBackend->Read(func, maxCount);
+  }
 
-    using std::chrono::duration_cast;
-    using std::chrono::microseconds;
-    using std::chrono::steady_clock;
+  u64 GetDroppedEntries(Class logClass) const {
+    return droppedEntries[static_cast<size_t>(logClass)].load(std::memory_order_relaxed);
+  }
 
-    const Entry entry = {
-      .timestamp = duration_cast<microseconds>(steady_clock::now() - timeOrigin),
-      .logClass = logClass,
-      .logLevel = logLevel,
-      .filename = filename,
-      .lineNum = lineNum,
-      .function = function,
-      .message = message,
-    };
-    if (Config::logType() == "async") {
-      messageQueue.EmplaceWait(entry);
-    } else {
-      ForEachBackend([&entry](BaseBackend* backend) { if (backend) { backend->Write(entry); } });
-      std::fflush(stdout);
-    }
+  void PushEntry(Class logClass, Level logLevel, const char *filename, u32 lineNum,
+           const char *function, std::string &&message) {
+    Entry entry = CreateEntry(logClass, logLevel, filename, lineNum, function);
+    entry.message = std::move(message);
+    DispatchEntry(entry);
+  }
+
+  void PushDeferredEntry(Class logClass, Level logLevel, const char *filename, u32 lineNum,
+           const char *function, const char *format, const ArgBuffer &args) {
+    Entry entry = CreateEntry(logClass, logLevel, filename, lineNum, function);
+    entry.format = format;
+    entry.args.size = args.size;
+    std::memcpy(entry.args.data.data(), args.data.data(), args.size);
+    DispatchEntry(entry);
   }
 
   void PushEntryNoFmt(Class logClass, Level logLevel, const std::string &message) {
-    if (!filter.CheckMessage(logClass, logLevel)) {
+    if (!IsEnabled(logClass, logLevel)) {
       return;
     }
 
-    using std::chrono::duration_cast;
-    using std::chrono::microseconds;
-    using std::chrono::steady_clock;
-
-    const Entry entry = {
-      .timestamp = duration_cast<microseconds>(steady_clock::now() - timeOrigin),
-      .logClass = logClass,
-      .logLevel = logLevel,
-      .message = message,
-      .formatted = false
-    };
-    if (Config::logType() == "async") {
-      messageQueue.EmplaceWait(entry);
-    } else {
-      ForEachBackend([&entry](BaseBackend* backend) { if (backend) { backend->Write(entry); } });
-      std::fflush(stdout);
-    }
+    Entry entry = CreateEntry(logClass, logLevel, nullptr, 0, nullptr);
+    entry.message = message;
+    entry.formatted = false;
+    DispatchEntry(entry);
   }
 
 private:
-  Impl(const fs::path &fileBackendFilename, const Filter &filter) :
-    filter(filter) {
+  Impl(const fs::path &fileBackendFilename, const Filter &filter_) {
+    SetGlobalFilter(filter_);
 #ifdef _WIN32
     HANDLE conOut = GetStdHandle(STD_OUTPUT_HANDLE);
     // Get current console mode
@@ -217,40 +445,203 @@ private:
     SetConsoleMode(conOut, mode);
 #endif
     colorConsoleBackend = std::make_unique<ColorConsoleBackend>();
-    fileBackend = std::make_unique<FileBackend>(fileBackendFilename);
+    viewerBackend = std::make_unique<ViewerBackend>();
+    if (Config::isBinaryLog()) {
+      binaryFileBackend = std::make_unique<BinaryFileBackend>(
+        fs::path(fileBackendFilename).replace_extension(".plog"));
+    } else {
+      fileBackend = std::make_unique<FileBackend>(fileBackendFilename);
+    }
   }
 
   ~Impl() {
     Stop();
+    binaryFileBackend.reset();
     fileBackend.reset();
+    viewerBackend.reset();
     colorConsoleBackend.reset();
   }
 
+  Entry CreateEntry(Class logClass, Level logLevel, const char *filename, u32 lineNum,
+           const char *function) const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    Entry entry;
+    entry.timestamp = duration_cast<microseconds>(steady_clock::now() - timeOrigin);
+    entry.logClass = logClass;
+    entry.logLevel = logLevel;
+    entry.filename = filename;
+    entry.lineNum = lineNum;
+    entry.function = function;
+    return entry;
+  }
+
+  // Queues the entry for the log thread, or writes it out right away in sync mode
+  void DispatchEntry(Entry &entry) {
+    if (Config::logMode() == Config::LogMode::Async) {
+      switch (Config::logOverflow()) {
+      case Config::LogOverflow::Block:
+        messageQueue.EmplaceWait(entry);
+        break;
+      case Config::LogOverflow::DropNewest:
+        if (!messageQueue.TryEmplace(entry)) {
+          CountDroppedEntry(entry);
+        }
+        break;
+      case Config::LogOverflow::DropOldest:
+        // Falls back to dropping the new entry while the log thread holds the oldest one
+        if (!messageQueue.EmplaceOverwrite(
+              [this](const Entry &evicted) { CountDroppedEntry(evicted); }, entry)) {
+          CountDroppedEntry(entry);
+        }
+        break;
+      }
+    } else {
+      thread_local DeferredArgStore store;
+      // No EndBatch() per entry, that would be a write and a stdout flush per message. The
+      // buffers are written out when full and by the log thread timer, see StartBackendThread
+      std::scoped_lock lock{syncWriteMutex};
+      WriteEntry(entry, store);
+    }
+  }
+
+  // Hands the entry to every backend. The binary log stores deferred entries as they are, so
+  // they are only formatted if a text backend wants them.
+  void WriteEntry(Entry &entry, DeferredArgStore &store) {
+    if (binaryFileBackend) {
+      binaryFileBackend->Write(entry);
+    }
+    if (!fileBackend && !colorConsoleBackend->IsEnabled() && !viewerBackend->IsEnabled()) {
+      return;
+    }
+    if (entry.format) {
+      FormatDeferredEntry(entry, store);
+    }
+    colorConsoleBackend->Write(entry);
+    if (fileBackend) {
+      fileBackend->Write(entry);
+    }
+    viewerBackend->Write(entry);
+  }
+
+  // Writes out up to MaxBatchSize queued entries, false if there were none
+  template <typename Func>
+  bool WriteBatch(Func &writeLog) {
+    SCOPED_TRACE("Log::WriteBatch");
+    if (messageQueue.ConsumeBatch(writeLog, MaxBatchSize) == 0) {
+      return false;
+    }
+    ForEachBackend([](BaseBackend *backend) { backend->EndBatch(); });
+    return true;
+  }
+
   void StartBackendThread() {
     backendThread = std::jthread([this](std::stop_token stopToken) {
       Base::SetCurrentThreadName("[Xe] Log");
-      Entry entry = {};
-      const auto writeLogs = [this, &entry]() {
-        ForEachBackend([&entry](BaseBackend *backend) { backend->Write(entry); });
-      };
+      DeferredArgStore store;
+      // Entries are formatted and written in place, straight out of their queue slot
+      const auto writeLog = [this, &store](Entry &entry) { WriteEntry(entry, store); };
+      std::array<u64, static_cast<size_t>(Class::Count)> reportedDrops = {};
+      auto nextFlush = std::chrono::steady_clock::now() + FlushInterval;
+      auto nextReport = std::chrono::steady_clock::now() + ReportInterval;
       while (!stopToken.stop_requested()) {
-        if (messageQueue.PopWait(entry, stopToken))
-          writeLogs();
+        if (!WriteBatch(writeLog)) {
+          messageQueue.WaitForData(stopToken, FlushInterval);
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextFlush) {
+          SCOPED_TRACE("Log::Flush");
+          // Also flushes what sync mode writers left in the buffers
+          std::scoped_lock lock{syncWriteMutex};
+          ForEachBackend([](BaseBackend *backend) { backend->Flush(); });
+          nextFlush = now + FlushInterval;
+        }
+        if (now >= nextReport) {
+          // Written from here instead of queued, so sync mode writers must be kept out
+          std::scoped_lock lock{syncWriteMutex};
+          ReportDroppedEntries(reportedDrops, writeLog);
+          ReportLimitedCallsites(writeLog);
+          nextReport = now + ReportInterval;
+        }
       }
       // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
       // case where a system is repeatedly spamming logs even on close.
-      s32 maxLogsToWrite = filter.IsDebug() ? std::numeric_limits<s32>::max() : 100;
-      while (maxLogsToWrite-- > 0) {
-        if (messageQueue.TryPop(entry)) {
-          writeLogs();
-        } else {
-          break;
-        }
+      const size_t maxLogsToWrite = filter.IsDebug() ? std::numeric_limits<size_t>::max() : 100;
+      messageQueue.ConsumeBatch(writeLog, maxLogsToWrite);
+    });
+  }
+
+  void CountDroppedEntry(const Entry &entry) {
+    droppedEntries[static_cast<size_t>(entry.logClass)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Writes a summary of the entries dropped since the last report, if there were any
+  template <typename Func>
+  void ReportDroppedEntries(std::array<u64, static_cast<size_t>(Class::Count)> &reported,
+                            Func &&writeLog) {
+    std::string counts;
+    u64 total = 0;
+    for (size_t i = 0; i < reported.size(); i++) {
+      const u64 dropped = droppedEntries[i].load(std::memory_order_relaxed);
+      if (dropped == reported[i]) {
+        continue;
+      }
+      fmt::format_to(std::back_inserter(counts), "{}{}: {}", counts.empty() ? "" : ", ",
+                     GetLogClassName(static_cast<Class>(i)), dropped - reported[i]);
+      total += dropped - reported[i];
+      reported[i] = dropped;
+    }
+    if (total == 0) {
+      return;
+    }
+    Entry entry = CreateEntry(Class::Log, Level::Warning, nullptr, 0, nullptr);
+    entry.message = fmt::format("Log queue full, dropped {} messages ({})", total, counts);
+    writeLog(entry);
+  }
+
+  // Writes the messages suppressed by every callsite limiter since the last report
+  template <typename Func>
+  void ReportLimitedCallsites(Func &&writeLog) {
+    for (CallsiteLimiter *callsite = limitedCallsites.load(std::memory_order_acquire);
+         callsite; callsite = callsite->next) {
+      const u32 repeated = callsite->repeated.exchange(0, std::memory_order_relaxed);
+      const u32 suppressed = callsite->suppressed.exchange(0, std::memory_order_relaxed);
+      if (repeated == 0 && suppressed == 0) {
+        continue;
       }
+      Entry entry = CreateEntry(callsite->logClass, callsite->logLevel, callsite->filename,
+                                callsite->lineNum, "");
+      // Not necessarily right after the message in question, so name the callsite
+      entry.message = fmt::format("{}:{}: ", callsite->filename, callsite->lineNum);
+      if (suppressed != 0) {
+        fmt::format_to(std::back_inserter(entry.message),
+                       "{} messages suppressed by the rate limit{}", suppressed,
+                       repeated != 0 ? ", " : "");
+      }
+      if (repeated != 0) {
+        fmt::format_to(std::back_inserter(entry.message), "last message repeated {} times",
+                       repeated);
+      }
+      writeLog(entry);
+    }
+  }
+
+  void StartCleanupThread(const fs::path &logDir, const fs::path &currentLog) {
+    cleanupThread = std::jthread([logDir, currentLog](std::stop_token stopToken) {
+      Base::SetCurrentThreadName("[Xe] LogCleanup");
+      Base::SetCurrentThreadPriority(ThreadPriority::Low);
+      CleanupOldLogs(logDir, currentLog, {}, stopToken);
     });
   }
 
   void StopBackendThread() {
+    // Stopped first, it logs what it removed
+    cleanupThread.request_stop();
+    if (cleanupThread.joinable()) {
+      cleanupThread.join();
+    }
     backendThread.request_stop();
     if (backendThread.joinable()) {
       backendThread.join();
@@ -261,7 +652,12 @@ private:
 
   void ForEachBackend(std::function<void(BaseBackend*)> lambda) {
     lambda(colorConsoleBackend.get());
-    lambda(fileBackend.get());
+    if (fileBackend) {
+      lambda(fileBackend.get());
+    }
+    if (binaryFileBackend) {
+      lambda(binaryFileBackend.get());
+    }
   }
 
   static void Deleter(Impl* ptr) {
@@ -273,134 +669,102 @@ private:
   Filter filter;
   std::unique_ptr<ColorConsoleBackend> colorConsoleBackend = {};
   std::unique_ptr<FileBackend> fileBackend = {};
+  std::unique_ptr<BinaryFileBackend> binaryFileBackend = {};
+  std::unique_ptr<ViewerBackend> viewerBackend = {};
+
+  // Entries written by the log thread before it checks the queue again
+  static constexpr size_t MaxBatchSize = 256;
+
+  // How often the log thread flushes the backends
+  static constexpr std::chrono::seconds FlushInterval{1};
+
+  // How often the log thread reports entries dropped because the queue was full, and those
+  // suppressed by callsite limiters
+  static constexpr std::chrono::seconds ReportInterval{5};
 
   MPSCQueue<Entry> messageQueue = {};
+  // Serializes sync mode writers, which share the backend buffers with the log thread
+  std::mutex syncWriteMutex;
+  std::array<std::atomic<u64>, static_cast<size_t>(Class::Count)> droppedEntries = {};
   std::chrono::steady_clock::time_point timeOrigin = std::chrono::steady_clock::now();
   std::jthread backendThread;
+  std::jthread cleanupThread;
 };
 
-std::vector<fs::path> filepaths{};
-
-void DeleteOldLogs(const fs::path& path, u64 num_logs, const u16 logLimit) {
-  const std::string filename = path.filename().string();
-  const std::chrono::time_point Now = std::chrono::system_clock::now();
-  const time_t timeNow = std::chrono::system_clock::to_time_t(Now);
-  const tm* time = std::localtime(&timeNow);
-  // We want to get rid of anything that isn't that current day's date
-  const std::string currentDate = fmt::format("{}-{}-{}", time->tm_mon + 1, time->tm_mday, 1900 + time->tm_year);
-  if (filename.find(currentDate) == std::string::npos) {
-    fs::remove_all(path);
-    return;
-  }
-  // We want to delete in date of creation, so just add it to a array
-  if (num_logs >= logLimit) {
-    filepaths.push_back(path);
+void CleanupOldLogs(const fs::path &logDir, const fs::path &currentLog,
+                    const LogRetention &retention, std::stop_token stopToken) {
+  struct LogFile {
+    fs::path path;
+    fs::file_time_type modified;
+    u64 size;
+  };
+  std::vector<LogFile> logs;
+  std::error_code ec;
+  for (auto it = fs::directory_iterator(logDir, ec); !ec && it != fs::directory_iterator();
+       it.increment(ec)) {
+    if (stopToken.stop_requested()) {
+      return;
+    }
+    const fs::path &path = it->path();
+    const fs::path extension = path.extension();
+    // Text and binary logs, but never the ones this session writes to
+    // The iterator's error code only reports failed increments, each query gets its own
+    std::error_code typeError;
+    if ((extension != ".txt" && extension != ".plog") || path.stem() == currentLog.stem() ||
+        !it->is_regular_file(typeError)) {
+      continue;
+    }
+    std::error_code timeError;
+    std::error_code sizeError;
+    const fs::file_time_type modified = it->last_write_time(timeError);
+    const u64 size = it->file_size(sizeError);
+    if (!timeError && !sizeError) {
+      logs.push_back({ path, modified, size });
+    }
   }
-}
-
-u64 CreateIntegralTimestamp(const std::string &date) {
-  const u64 monthPos = date.find('-');
-  if (monthPos == std::string::npos) {
-    return 0;
-  }
-  const std::string month = date.substr(0, monthPos);
-  const u64 dayPos = date.find('-', monthPos);
-  if (dayPos == std::string::npos) {
-    return 0;
-  }
-  const u64 yearPos = date.find('-', dayPos);
-  const std::string day = date.substr(monthPos+1);
-  if (yearPos == std::string::npos) {
-    return 0;
-  }
-  const std::string year = date.substr(yearPos + 1);
-  const u64 yearInt = std::stoull(year);
-  const std::string timestamp = fmt::format("{}{}{}", month, day, yearInt - 1900);
-  return std::stoull(timestamp);
-}
 
-void CleanupOldLogs(const std::string_view &logFileBase, const fs::path &logDir, const u16 logLimit) {
-  const fs::path LogFile = logFileBase;
-  // Track how many logs we have
-  size_t numLogs = 0;
-  for (auto &entry : fs::directory_iterator(logDir)) {
-    if (entry.is_regular_file()) {
-      const fs::path path = entry.path();
-      const std::string ext = path.extension().string();
-      if (!path.has_extension()) {
-        // Skip anything that isn't a log file
-        continue;
-      }
-      if (ext != LogFile.extension()) {
-        // Skip anything that isn't a log file
-        continue;
-      }
-      numLogs++;
-      DeleteOldLogs(path, numLogs, logLimit);
-    } else {
-      // Skip anything that isn't a file
+  // Keep the newest logs within every limit, the rest goes
+  std::sort(logs.begin(), logs.end(),
+            [](const LogFile &a, const LogFile &b) { return a.modified > b.modified; });
+  const fs::file_time_type oldest = fs::file_time_type::clock::now() - retention.maxAge;
+  u64 keptSize = 0;
+  size_t kept = 0;
+  size_t removed = 0;
+  u64 removedSize = 0;
+  for (const LogFile &log : logs) {
+    if (stopToken.stop_requested()) {
+      break;
+    }
+    if (kept < retention.maxLogs && keptSize + log.size <= retention.maxTotalSize &&
+        log.modified >= oldest) {
+      kept++;
+      keptSize += log.size;
       continue;
     }
-  }
-  if (filepaths.empty()) {
-    return;
-  }
-  u64 numToDelete{ logLimit };
-  std::map<u64, fs::path> date_sorted_paths{};
-  for (const auto &path : filepaths) {
-    const std::string stem = path.stem().string();
-    u64 basePos = stem.find('_');
-    // If we cannot get the base, just delete it
-    if (basePos == std::string::npos) {
-      numToDelete--;
-      fs::remove_all(path);
-    } else {
-      const std::string base = stem.substr(0, basePos);
-      const u64 datePos = base.find('_', basePos+1);
-      const std::string date = base.substr(datePos+1);
-      const u64 dateInt = CreateIntegralTimestamp(date);
-      if (datePos == std::string::npos) {
-        // If we cannot find the date, just delete it
-        numToDelete--;
-        fs::remove_all(path);
-      } else {
-        const u64 timePos = base.find('_', datePos+1);
-        const std::string time = base.substr(timePos+1);
-        const u64 timestamp = CreateIntegralTimestamp(time);
-        if (!timestamp) {
-          numToDelete--;
-          fs::remove_all(path);
-          continue;
-        }
-        date_sorted_paths.insert({ dateInt + timestamp, path });
-      }
+    if (fs::remove(log.path, ec)) {
+      removed++;
+      removedSize += log.size;
     }
   }
-  // Start deleting based off timestamp
-  for (const auto &entry : date_sorted_paths) {
-    fs::remove_all(entry.second);
+  if (removed != 0) {
+    LOG_INFO(Log, "Removed {} old log files ({} bytes)", removed, removedSize);
   }
 }
 
 void Initialize(const std::string_view &logFile) {
   // Create directory vars to so we can use fs::path::stem
-  const fs::path LogDir = GetUserPath(PathType::LogDir);
   const fs::path LogFile = LOG_FILE;
   const fs::path LogFileStem = LogFile.stem();
-  const fs::path LogFileName = LogFile.filename();
   // This is to make string_view happy
   const std::string LogFileStemStr = LogFileStem.string();
-  const std::string LogFileNameStr = LogFileName.string();
   // Setup filename
   const std::string_view filestemBase = logFile.empty() ? LogFileStemStr : logFile;
-  const std::string_view filenameBase = logFile.empty() ? LogFileNameStr : logFile;
   const std::chrono::time_point now = std::chrono::system_clock::now();
   const time_t timeNow = std::chrono::system_clock::to_time_t(now);
   const tm *time = std::localtime(&timeNow);
   const std::string currentTime = fmt::format("{}-{}-{}", time->tm_hour, time->tm_min, time->tm_sec);
   const std::string currentDate = fmt::format("{}-{}-{}", time->tm_mon + 1, time->tm_mday, 1900 + time->tm_year);
   const std::string filename = fmt::format("{}_{}_{}.txt", filestemBase, currentDate, currentTime);
-  CleanupOldLogs(filenameBase, LogDir);
   Impl::Initialize(logFile.empty() ? filename : logFile);
 }
 
@@ -424,12 +788,91 @@ void SetColorConsoleBackendEnabled(bool enabled) {
   Impl::Instance().SetColorConsoleBackendEnabled(enabled);
 }
 
+void SetViewerEnabled(bool enabled) {
+  Impl::Instance().SetViewerEnabled(enabled);
+}
+
+size_t ReadViewerEntries(const std::function<void(ViewerEntry&)> &func, size_t maxCount) {
+  return IsActive() ? Impl::Instance().ReadViewerEntries(func, maxCount) : 0;
+}
+
+u64 GetDroppedMessages(Class logClass) {
+  return IsActive() ? Impl::Instance().GetDroppedEntries(logClass) : 0;
+}
+
+static void RegisterLimitedCallsite(CallsiteLimiter &callsite) {
+  if (callsite.registered.load(std::memory_order_relaxed) ||
+      callsite.registered.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
+  CallsiteLimiter *head = limitedCallsites.load(std::memory_order_relaxed);
+  do {
+    callsite.next = head;
+  } while (!limitedCallsites.compare_exchange_weak(head, &callsite, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+}
+
+// FNV-1a, only used to tell consecutive messages of one callsite apart
+static u64 HashBytes(const void *data, size_t size) {
+  u64 hash = 0xCBF29CE484222325ULL;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ static_cast<const u8*>(data)[i]) * 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+bool CallsiteLimiter::Admit(u64 hash) {
+  if (lastHash.exchange(hash, std::memory_order_relaxed) == hash) {
+    repeated.fetch_add(1, std::memory_order_relaxed);
+    RegisterLimitedCallsite(*this);
+    return false;
+  }
+  if (const u32 count = repeated.exchange(0, std::memory_order_relaxed); count != 0) {
+    Impl::Instance().PushEntry(logClass, logLevel, filename, lineNum, "",
+                   fmt::format("Last message repeated {} times", count));
+  }
+
+  constexpr s64 interval = 1'000'000'000 / RatePerSecond;
+  const s64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  s64 arrival = theoreticalArrival.load(std::memory_order_relaxed);
+  while (true) {
+    const s64 nextArrival = std::max(arrival, now) + interval;
+    if (nextArrival - now > interval * Burst) {
+      suppressed.fetch_add(1, std::memory_order_relaxed);
+      RegisterLimitedCallsite(*this);
+      return false;
+    }
+    if (theoreticalArrival.compare_exchange_weak(arrival, nextArrival,
+                                                 std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+}
+
 void FmtLogMessageImpl(Class logClass, Level logLevel, const char *filename,
              u32 lineNum, const char *function, const char *format,
-             const fmt::format_args &args) {
-  if (!currentlyInitialising) [[likely]] {
+             const fmt::format_args &args, CallsiteLimiter *callsite) {
+  // Callers going through the LOG_* macros are already filtered, direct callers are not
+  if (!currentlyInitialising && IsEnabled(logClass, logLevel)) [[likely]] {
+    std::string message = fmt::vformat(format, args);
+    if (callsite && !callsite->Admit(HashBytes(message.data(), message.size()))) {
+      return;
+    }
     Impl::Instance().PushEntry(logClass, logLevel, filename, lineNum, function,
-                   fmt::vformat(format, args));
+                   std::move(message));
+  }
+}
+
+void DeferredLogMessageImpl(Class logClass, Level logLevel, const char *filename,
+             u32 lineNum, const char *function, const char *format,
+             const ArgBuffer &args, CallsiteLimiter *callsite) {
+  if (!currentlyInitialising && IsEnabled(logClass, logLevel)) [[likely]] {
+    if (callsite && !callsite->Admit(HashBytes(args.data.data(), args.size))) {
+      return;
+    }
+    Impl::Instance().PushDeferredEntry(logClass, logLevel, filename, lineNum, function, format,
+                   args);
   }
 }
 
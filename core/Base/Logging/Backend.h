@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <stop_token>
+#include <string>
 #include <string_view>
 #include <filesystem>
 
@@ -14,8 +18,17 @@ namespace Log {
 
 class Filter;
 
-/// Cleans up logs from previous days, and any logs within the desired limit
-void CleanupOldLogs(const std::string_view &logFileBase, const fs::path &logDir, const u16 logLimit = 50);
+/// Limits on the logs kept in the log directory, the newest logs are kept first
+struct LogRetention {
+  size_t maxLogs = 50;
+  u64 maxTotalSize = 512_MB;
+  std::chrono::hours maxAge = std::chrono::days{ 14 };
+};
+
+/// Removes the text and binary logs in `logDir` exceeding `retention`, by modification time.
+/// `currentLog` is always kept. Initialize() runs this on a low priority thread.
+void CleanupOldLogs(const fs::path &logDir, const fs::path &currentLog,
+                    const LogRetention &retention = {}, std::stop_token stopToken = {});
 
 /// Initializes the logging system
 void Initialize(const std::string_view &logFile = {});
@@ -33,5 +46,25 @@ void SetGlobalFilter(const Filter &filter);
 
 void SetColorConsoleBackendEnabled(bool enabled);
 
+/// Number of messages of this class dropped so far because the log queue was full
+u64 GetDroppedMessages(Class logClass);
+
+/// A formatted log entry, as handed to in-process viewers such as the GUI console
+struct ViewerEntry {
+  std::chrono::microseconds timestamp = {};
+  Class logClass = {};
+  Level logLevel = {};
+  std::string message = {};
+};
+
+/// Starts or stops copying formatted entries into the lock-free viewer ring. The log thread never
+/// waits for the viewer, entries that don't fit in the ring are dropped.
+void SetViewerEnabled(bool enabled);
+
+/// Passes up to `maxCount` entries from the viewer ring to `func`, oldest first, and returns how
+/// many there were. Only one thread may read the viewer ring. Swapping the message out of the
+/// entry instead of copying it lets both sides reuse their string storage.
+size_t ReadViewerEntries(const std::function<void(ViewerEntry&)> &func, size_t maxCount);
+
 } // namespace Log
 } // namespace Base
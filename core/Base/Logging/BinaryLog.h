@@ -0,0 +1,293 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include "Base/Types.h"
+
+#include "LogEntry.h"
+
+/*
+ * Binary log files (.plog), shared by the binary log backend and the log decoder tool.
+ *
+ * A file starts with a header:
+ *   "PLOG", u8 version, varint class count, class names, varint level count, level names
+ * followed by records, each starting with a RecordType byte:
+ *   Callsite: varint id, varint line, format, filename, function
+ *   Message:  zigzag varint timestamp delta (us), u8 class, u8 level, varint callsite id,
+ *             varint argument size, the arguments
+ *   Text:     zigzag varint timestamp delta (us), u8 class, u8 level, u8 formatted, message
+ * Strings are a varint length followed by the characters, integers use LEB128 varints.
+ *
+ * Message arguments keep the ArgType tags of ArgBuffer, but integers and pointers are stored as
+ * (zigzag) varints and string lengths as varints. Floats are stored as they are.
+ *
+ * Callsites are defined the first time one of their messages is written, so a truncated file
+ * still decodes up to the last complete record. Floats are stored in host byte order.
+ */
+namespace Base {
+namespace Log {
+namespace BinaryLog {
+
+constexpr std::string_view Magic = "PLOG";
+constexpr u8 Version = 1;
+
+enum class RecordType : u8 {
+  Callsite,
+  Message,
+  Text,
+};
+
+inline void WriteVarint(std::string &out, u64 value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline void WriteSignedVarint(std::string &out, s64 value) {
+  WriteVarint(out, (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63));
+}
+
+inline void WriteString(std::string &out, std::string_view string) {
+  WriteVarint(out, string.size());
+  out.append(string);
+}
+
+/// Sequential reader over a decoded file, every read returns false once the data runs out
+class Reader {
+public:
+  explicit Reader(std::span<const u8> data_) : data(data_) {}
+
+  bool AtEnd() const {
+    return offset == data.size();
+  }
+
+  bool ReadByte(u8 &value) {
+    if (offset >= data.size()) {
+      return false;
+    }
+    value = data[offset++];
+    return true;
+  }
+
+  bool ReadVarint(u64 &value) {
+    value = 0;
+    for (u32 shift = 0; shift < 64; shift += 7) {
+      u8 byte = 0;
+      if (!ReadByte(byte)) {
+        return false;
+      }
+      value |= static_cast<u64>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadSignedVarint(s64 &value) {
+    u64 encoded = 0;
+    if (!ReadVarint(encoded)) {
+      return false;
+    }
+    value = static_cast<s64>((encoded >> 1) ^ (~(encoded & 1) + 1));
+    return true;
+  }
+
+  bool ReadBytes(u64 size, std::span<const u8> &bytes) {
+    if (size > data.size() - offset) {
+      return false;
+    }
+    bytes = data.subspan(offset, size);
+    offset += size;
+    return true;
+  }
+
+  bool ReadString(std::string &string) {
+    u64 size = 0;
+    std::span<const u8> bytes;
+    if (!ReadVarint(size) || !ReadBytes(size, bytes)) {
+      return false;
+    }
+    string.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return true;
+  }
+
+private:
+  std::span<const u8> data;
+  size_t offset = 0;
+};
+
+/// Appends the ArgBuffer encoded arguments `args` to `out` in their compact file encoding
+inline void WriteArgs(std::string &out, std::span<const u8> args) {
+  size_t offset = 0;
+  const auto read = [&args, &offset]<typename T>(T &value) {
+    std::memcpy(&value, &args[offset], sizeof(T));
+    offset += sizeof(T);
+  };
+  while (offset < args.size()) {
+    const ArgType type = static_cast<ArgType>(args[offset++]);
+    out.push_back(static_cast<char>(type));
+    switch (type) {
+    case ArgType::I64: {
+      s64 value = 0;
+      read(value);
+      WriteSignedVarint(out, value);
+      break;
+    }
+    case ArgType::U64:
+    case ArgType::Pointer: {
+      u64 value = 0;
+      read(value);
+      WriteVarint(out, value);
+      break;
+    }
+    case ArgType::String: {
+      u16 length = 0;
+      read(length);
+      WriteString(out, std::string_view(reinterpret_cast<const char*>(&args[offset]), length));
+      offset += length;
+      break;
+    }
+    default: {
+      const size_t size = type == ArgType::F32 ? 4 : type == ArgType::F64 ? 8 : 1;
+      out.append(reinterpret_cast<const char*>(&args[offset]), size);
+      offset += size;
+      break;
+    }
+    }
+  }
+}
+
+/// Decodes arguments written by WriteArgs() back into an ArgBuffer, false if they are malformed
+inline bool ReadArgs(Reader &reader, u64 size, ArgBuffer &args) {
+  std::span<const u8> bytes;
+  if (!reader.ReadBytes(size, bytes)) {
+    return false;
+  }
+  Reader argReader(bytes);
+  args.size = 0;
+  const auto push = [&args](const void *data, size_t length) {
+    if (args.size + length > ArgBuffer::Capacity) {
+      return false;
+    }
+    std::memcpy(&args.data[args.size], data, length);
+    args.size += static_cast<u16>(length);
+    return true;
+  };
+  while (!argReader.AtEnd()) {
+    u8 tag = 0;
+    argReader.ReadByte(tag);
+    if (!push(&tag, 1)) {
+      return false;
+    }
+    bool valid = false;
+    switch (static_cast<ArgType>(tag)) {
+    case ArgType::I64: {
+      s64 value = 0;
+      valid = argReader.ReadSignedVarint(value) && push(&value, sizeof(value));
+      break;
+    }
+    case ArgType::U64:
+    case ArgType::Pointer: {
+      u64 value = 0;
+      valid = argReader.ReadVarint(value) && push(&value, sizeof(value));
+      break;
+    }
+    case ArgType::String: {
+      u64 length = 0;
+      std::span<const u8> string;
+      valid = argReader.ReadVarint(length) && length <= ArgBuffer::Capacity &&
+              argReader.ReadBytes(length, string);
+      if (valid) {
+        const u16 length16 = static_cast<u16>(length);
+        valid = push(&length16, sizeof(length16)) && push(string.data(), string.size());
+      }
+      break;
+    }
+    case ArgType::F32:
+    case ArgType::F64:
+    case ArgType::Bool:
+    case ArgType::Char: {
+      const ArgType type = static_cast<ArgType>(tag);
+      const size_t length = type == ArgType::F32 ? 4 : type == ArgType::F64 ? 8 : 1;
+      std::span<const u8> value;
+      valid = argReader.ReadBytes(length, value) && push(value.data(), value.size());
+      break;
+    }
+    default:
+      break;
+    }
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+using ArgStore = fmt::dynamic_format_arg_store<fmt::format_context>;
+
+/*
+ * Appends `format` formatted with the arguments encoded in `args` (see ArgBuffer) to `out`.
+ * Returns false if the buffer is malformed. Throws fmt::format_error on invalid format strings.
+ */
+inline bool FormatArgs(std::string &out, const char *format, std::span<const u8> args,
+                       ArgStore &store) {
+  const auto read = [&args]<typename T>(size_t &offset, T &value) {
+    if (args.size() - offset < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, &args[offset], sizeof(T));
+    offset += sizeof(T);
+    return true;
+  };
+  store.clear();
+  size_t offset = 0;
+  while (offset < args.size()) {
+    bool valid = false;
+    switch (static_cast<ArgType>(args[offset++])) {
+    case ArgType::I64: { s64 v = 0; valid = read(offset, v); store.push_back(v); break; }
+    case ArgType::U64: { u64 v = 0; valid = read(offset, v); store.push_back(v); break; }
+    case ArgType::F32: { f32 v = 0; valid = read(offset, v); store.push_back(v); break; }
+    case ArgType::F64: { f64 v = 0; valid = read(offset, v); store.push_back(v); break; }
+    case ArgType::Bool: { bool v = false; valid = read(offset, v); store.push_back(v); break; }
+    case ArgType::Char: { char v = 0; valid = read(offset, v); store.push_back(v); break; }
+    case ArgType::String: {
+      u16 length = 0;
+      valid = read(offset, length) && length <= args.size() - offset;
+      if (valid) {
+        // Not copied by the store, the arguments outlive the vformat call
+        store.push_back(fmt::string_view(reinterpret_cast<const char*>(&args[offset]), length));
+        offset += length;
+      }
+      break;
+    }
+    case ArgType::Pointer: {
+      u64 v = 0;
+      valid = read(offset, v);
+      store.push_back(reinterpret_cast<const void*>(static_cast<uptr>(v)));
+      break;
+    }
+    default:
+      break;
+    }
+    if (!valid) {
+      return false;
+    }
+  }
+  fmt::vformat_to(std::back_inserter(out), format, store);
+  return true;
+}
+
+} // namespace BinaryLog
+} // namespace Log
+} // namespace Base
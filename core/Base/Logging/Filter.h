@@ -52,6 +52,11 @@ public:
    */
   void ParseFilterString(const std::string_view &filterView);
 
+  /// Returns the minimum level of `logClass`.
+  Level GetClassLevel(Class logClass) const {
+    return classLevels[static_cast<size_t>(logClass)];
+  }
+
   /// Matches class/level combination against the filter, returning true if it passed.
   bool CheckMessage(Class logClass, Level level) const;
 
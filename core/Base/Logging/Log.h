@@ -3,10 +3,17 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <fmt/format.h>
 
 #include "Base/Config.h"
 
+#include "LogEntry.h"
 #include "LogTypes.h"
 
 namespace Base {
@@ -20,59 +27,186 @@ constexpr const char* TrimSourcePath(const std::string_view &source) {
   return source.data() + idx;
 }
 
+/*
+ * Minimum level of every log class, mirrored from the global filter by SetGlobalFilter().
+ * The LOG_* macros check it before evaluating their arguments, so a filtered out log statement
+ * costs one relaxed load and a compare, even on hot paths.
+ */
+inline std::array<std::atomic<u8>, static_cast<size_t>(Class::Count)> classMinLevels = {};
+
+/// Returns true if a message of this class and level passes the global filter
+inline bool IsEnabled(Class logClass, Level logLevel) {
+  return static_cast<u8>(logLevel) >=
+         classMinLevels[static_cast<size_t>(logClass)].load(std::memory_order_relaxed);
+}
+
+/*
+ * Per-callsite state of a LOG_* statement, every expansion of the macro owns a static one.
+ *
+ * Rate limits the callsite with a token bucket (as GCRA, so the whole bucket is one atomic
+ * timestamp) allowing Burst messages at once and RatePerSecond sustained, and collapses
+ * consecutive identical messages into a "last message repeated N times" line. A callsite
+ * flooding the log, like an unimplemented instruction warning in a hot loop, can then neither
+ * fill the queue nor the file size cap. Suppressed counts are reported by the log thread.
+ */
+struct CallsiteLimiter {
+  static constexpr s64 RatePerSecond = 100;
+  static constexpr s64 Burst = 200;
+
+  constexpr CallsiteLimiter(Class logClass_, Level logLevel_, const char *filename_,
+                            u32 lineNum_) :
+    logClass(logClass_), logLevel(logLevel_), filename(filename_), lineNum(lineNum_)
+  {}
+
+  /// Returns false if a message with this hash must be dropped
+  bool Admit(u64 hash);
+
+  const Class logClass;
+  const Level logLevel;
+  const char *const filename;
+  const u32 lineNum;
+
+  // Earliest time (ns) at which the bucket is full again
+  std::atomic<s64> theoreticalArrival = 0;
+  std::atomic<u64> lastHash = 0;
+  std::atomic<u32> repeated = 0;
+  std::atomic<u32> suppressed = 0;
+  // Set once the callsite was linked into the list of callsites with suppressed messages
+  std::atomic<bool> registered = false;
+  CallsiteLimiter *next = nullptr;
+};
+
 /// Logs a message to the global logger, using fmt
 void FmtLogMessageImpl(Class logClass, Level logLevel, const char *filename,
                        u32 lineNum, const char *function, const char *format,
-                       const fmt::format_args& args);
+                       const fmt::format_args& args, CallsiteLimiter *callsite = nullptr);
+
+/// Logs a message whose arguments were captured in `args`, formatting happens on the log thread.
+/// `format` must outlive the logger, which holds for the string literals passed to LOG_*.
+void DeferredLogMessageImpl(Class logClass, Level logLevel, const char *filename,
+                            u32 lineNum, const char *function, const char *format,
+                            const ArgBuffer &args, CallsiteLimiter *callsite = nullptr);
 
 /// Logs a message without any formatting
 void NoFmtMessage(Class logClass, Level logLevel, const std::string &message);
 
+/// Returns the ArgBuffer tag used to capture a T, or ArgType::Count if T must be formatted eagerly
+template <typename T>
+constexpr ArgType DeferredArgType() {
+  using U = std::decay_t<T>;
+  if constexpr (std::is_same_v<U, bool>) {
+    return ArgType::Bool;
+  } else if constexpr (std::is_same_v<U, char>) {
+    return ArgType::Char;
+  } else if constexpr (std::is_same_v<U, wchar_t> || std::is_same_v<U, char8_t> ||
+                       std::is_same_v<U, char16_t> || std::is_same_v<U, char32_t>) {
+    return ArgType::Count;
+  } else if constexpr (std::is_integral_v<U> && sizeof(U) <= sizeof(u64)) {
+    return std::is_signed_v<U> ? ArgType::I64 : ArgType::U64;
+  } else if constexpr (std::is_same_v<U, float>) {
+    return ArgType::F32;
+  } else if constexpr (std::is_same_v<U, double>) {
+    return ArgType::F64;
+  } else if constexpr (std::is_same_v<U, char*> || std::is_same_v<U, const char*> ||
+                       std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+    return ArgType::String;
+  } else if constexpr (std::is_same_v<U, void*> || std::is_same_v<U, const void*> ||
+                       std::is_same_v<U, std::nullptr_t>) {
+    return ArgType::Pointer;
+  } else {
+    return ArgType::Count;
+  }
+}
+
+/// Appends one tagged argument to the buffer, returns false if it doesn't fit
+template <typename T>
+bool EncodeArg(ArgBuffer &buffer, const T &value) {
+  constexpr ArgType type = DeferredArgType<T>();
+  const auto push = [&buffer](const void *data, size_t size, size_t extra) {
+    if (buffer.size + 1 + size + extra > ArgBuffer::Capacity) {
+      return false;
+    }
+    buffer.data[buffer.size] = static_cast<u8>(type);
+    std::memcpy(&buffer.data[buffer.size + 1], data, size);
+    buffer.size += static_cast<u16>(1 + size);
+    return true;
+  };
+  if constexpr (type == ArgType::I64) {
+    const s64 widened = value;
+    return push(&widened, sizeof(widened), 0);
+  } else if constexpr (type == ArgType::U64) {
+    const u64 widened = value;
+    return push(&widened, sizeof(widened), 0);
+  } else if constexpr (type == ArgType::Pointer) {
+    const u64 address = reinterpret_cast<uptr>(static_cast<const void*>(value));
+    return push(&address, sizeof(address), 0);
+  } else if constexpr (type == ArgType::String) {
+    const std::string_view string = value;
+    if (string.size() > ArgBuffer::Capacity) {
+      return false;
+    }
+    const u16 length = static_cast<u16>(string.size());
+    if (!push(&length, sizeof(length), string.size())) {
+      return false;
+    }
+    std::memcpy(&buffer.data[buffer.size], string.data(), string.size());
+    buffer.size += length;
+    return true;
+  } else {
+    return push(&value, sizeof(value), 0);
+  }
+}
+
 template <typename... Args>
-void FmtLogMessage(Class logClass, Level logLevel, const char *filename, u32 lineNum,
-                   const char *function, const char *format, const Args&... args) {
-  FmtLogMessageImpl(logClass, logLevel, filename, lineNum, function, format,
-                    fmt::make_format_args(args...));
+void FmtLogMessage(CallsiteLimiter &callsite, const char *function, const char *format,
+                   const Args&... args) {
+  // Capture the raw arguments when possible so the caller neither formats nor allocates.
+  // Anything else (enums, paths, user types), or arguments too large for the buffer, are
+  // formatted right here as before.
+  if constexpr (((DeferredArgType<Args>() != ArgType::Count) && ...)) {
+    ArgBuffer buffer;
+    if ((EncodeArg(buffer, args) && ...)) {
+      DeferredLogMessageImpl(callsite.logClass, callsite.logLevel, callsite.filename,
+                             callsite.lineNum, function, format, buffer, &callsite);
+      return;
+    }
+  }
+  FmtLogMessageImpl(callsite.logClass, callsite.logLevel, callsite.filename, callsite.lineNum,
+                    function, format, fmt::make_format_args(args...), &callsite);
 }
 
 } // namespace Log
 } // namespace Base
 
 // Define the fmt lib macros
+// The level check comes first so the arguments of filtered out messages are never evaluated.
+// The callsite limiter is constant initialized, so it costs no guard check.
 #define LOG_GENERIC(logClass, logLevel, ...)                                             \
-  Base::Log::FmtLogMessage(logClass, logLevel, Base::Log::TrimSourcePath(__FILE__),      \
-                             __LINE__, __func__, __VA_ARGS__)
+  do {                                                                                   \
+    if (Base::Log::IsEnabled(logClass, logLevel)) {                                      \
+      static constinit Base::Log::CallsiteLimiter logCallsite_{                          \
+        logClass, logLevel, Base::Log::TrimSourcePath(__FILE__), __LINE__ };             \
+      Base::Log::FmtLogMessage(logCallsite_, __func__, __VA_ARGS__);                     \
+    }                                                                                    \
+  } while (0)
 #ifdef DEBUG_BUILD
 #define LOG_TRACE(logClass, ...)                                                         \
-if (Config::log.debugOnly)                                                               \
-  Base::Log::FmtLogMessage(Base::Log::Class::logClass, Base::Log::Level::Trace,          \
-                           Base::Log::TrimSourcePath(__FILE__), __LINE__, __func__,      \
-                           __VA_ARGS__)
+  LOG_GENERIC(Base::Log::Class::logClass, Base::Log::Level::Trace, __VA_ARGS__)
 #else
 #define LOG_TRACE(logClass, ...) ;
 #endif
 
 #ifdef DEBUG_BUILD
 #define LOG_DEBUG(logClass, ...)                                                         \
-  Base::Log::FmtLogMessage(Base::Log::Class::logClass, Base::Log::Level::Debug,          \
-                           Base::Log::TrimSourcePath(__FILE__), __LINE__, __func__,      \
-                           __VA_ARGS__)
+  LOG_GENERIC(Base::Log::Class::logClass, Base::Log::Level::Debug, __VA_ARGS__)
 #else
 #define LOG_DEBUG(logClass, ...) ;
 #endif
 #define LOG_INFO(logClass, ...)                                                          \
-  Base::Log::FmtLogMessage(Base::Log::Class::logClass, Base::Log::Level::Info,           \
-                           Base::Log::TrimSourcePath(__FILE__), __LINE__, __func__,      \
-                           __VA_ARGS__)
+  LOG_GENERIC(Base::Log::Class::logClass, Base::Log::Level::Info, __VA_ARGS__)
 #define LOG_WARNING(logClass, ...)                                                       \
-  Base::Log::FmtLogMessage(Base::Log::Class::logClass, Base::Log::Level::Warning,        \
-                           Base::Log::TrimSourcePath(__FILE__), __LINE__, __func__,      \
-                           __VA_ARGS__)
+  LOG_GENERIC(Base::Log::Class::logClass, Base::Log::Level::Warning, __VA_ARGS__)
 #define LOG_ERROR(logClass, ...)                                                         \
-  Base::Log::FmtLogMessage(Base::Log::Class::logClass, Base::Log::Level::Error,          \
-                           Base::Log::TrimSourcePath(__FILE__), __LINE__, __func__,      \
-                           __VA_ARGS__)
+  LOG_GENERIC(Base::Log::Class::logClass, Base::Log::Level::Error, __VA_ARGS__)
 #define LOG_CRITICAL(logClass, ...)                                                      \
-  Base::Log::FmtLogMessage(Base::Log::Class::logClass, Base::Log::Level::Critical,       \
-                           Base::Log::TrimSourcePath(__FILE__), __LINE__, __func__,      \
-                           __VA_ARGS__)
+  LOG_GENERIC(Base::Log::Class::logClass, Base::Log::Level::Critical, __VA_ARGS__)
@@ -2,16 +2,47 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <string>
 
 #include "LogTypes.h"
 
 namespace Base {
 namespace Log {
 
+/// Type tags of the arguments stored in an ArgBuffer
+enum class ArgType : u8 {
+  I64,     ///< Any signed integer, 8 byte payload
+  U64,     ///< Any unsigned integer, 8 byte payload
+  F32,     ///< 4 byte payload
+  F64,     ///< 8 byte payload
+  Bool,    ///< 1 byte payload
+  Char,    ///< 1 byte payload
+  String,  ///< u16 length followed by the characters, copied since the source may not outlive the call
+  Pointer, ///< 8 byte payload, formatted as an address
+  Count,   ///< Not a valid tag, marks types that can't be captured
+};
+
+/*
+ * The arguments of a log message whose formatting is deferred to the log thread. Each argument
+ * is stored as its ArgType tag followed by its payload, so the buffer is self-describing and
+ * needs no heap allocation.
+ */
+struct ArgBuffer {
+  static constexpr size_t Capacity = 192;
+
+  u16 size = 0;
+  std::array<u8, Capacity> data;
+};
+
 /*
  * A log entry. Log entries are store in a structured format to permit more varied output
  * formatting on different frontends, as well as facilitating filtering and aggregation.
+ *
+ * Entries pushed by the LOG_* macros normally carry the format string and their raw arguments,
+ * and are only formatted into `message` on the log thread. `format` is null once `message` holds
+ * the final text, which is always the case for entries whose arguments couldn't be deferred.
  */
 struct Entry {
   std::chrono::microseconds timestamp = {};
@@ -19,7 +50,9 @@ struct Entry {
   Level logLevel = {};
   const char *filename = nullptr;
   u32 lineNum = 0;
-  std::string function = {};
+  const char *function = nullptr;
+  const char *format = nullptr;
+  ArgBuffer args;
   std::string message = {};
   bool formatted = true;
 };
@@ -12,14 +12,20 @@ namespace Base {
 namespace Log {
 
 std::string FormatLogMessage(const Entry &entry) {
+  std::string out;
+  FormatLogMessage(entry, out);
+  return out;
+}
+
+void FormatLogMessage(const Entry &entry, std::string &out) {
   const char *className = GetLogClassName(entry.logClass);
   const char *levelName = GetLevelName(entry.logLevel);
 
   if (Config::isLogAdvanced() && entry.filename) {
-    return fmt::format("[{}] <{}> {}:{}:{}: {}", className, levelName, entry.filename,
-      entry.function, entry.lineNum, entry.message);
+    fmt::format_to(std::back_inserter(out), "[{}] <{}> {}:{}:{}: {}", className, levelName,
+      entry.filename, entry.function, entry.lineNum, entry.message);
   } else {
-    return fmt::format("[{}] <{}> {}", className, levelName, entry.message);
+    fmt::format_to(std::back_inserter(out), "[{}] <{}> {}", className, levelName, entry.message);
   }
 }
 
@@ -13,6 +13,9 @@ struct Entry;
 /// Formats a log entry into the provided text buffer.
 std::string FormatLogMessage(const Entry &entry);
 
+/// Appends the formatted log entry to `out`, so buffered writers can reuse their storage.
+void FormatLogMessage(const Entry &entry, std::string &out);
+
 /// Formats and prints a log entry to stderr.
 void PrintMessage(const std::string &color, const Entry &entry);
 
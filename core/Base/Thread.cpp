@@ -2,6 +2,7 @@
 
 #include "Thread.h" 
 #include "Error.h"
+#include "Trace.h"
 #include "Logging/Log.h"
 
 #ifdef __APPLE__
@@ -23,6 +24,13 @@
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#endif
 #include <thread>
 #include <algorithm>
 
@@ -142,6 +150,7 @@ static void AccurateSleep(std::chrono::nanoseconds duration) {
 
 // Sets the debugger-visible name of the current thread.
 void SetCurrentThreadName(const std::string_view &name) {
+  Trace::SetCurrentThreadName(name);
   SetThreadDescription(GetCurrentThread(), UTF8ToUTF16W(name).data());
 }
 
@@ -156,6 +165,7 @@ void SetThreadName(void *thread, const std::string_view &name) {
 // MinGW with the POSIX threading model does not support pthread_setname_np
 #if !defined(_WIN32) || defined(_MSC_VER)
 void SetCurrentThreadName(const std::string_view &name) {
+  Trace::SetCurrentThreadName(name);
   const char* nchar = name.data();
 #ifdef __APPLE__
   pthread_setname_np(nchar);
@@ -182,7 +192,8 @@ void SetThreadName(void *thread, const std::string_view &name) {
 
 #if defined(_WIN32)
 void SetCurrentThreadName(const std::string_view &name) {
-  // Do Nothing on MinGW
+  // Only named in traces on MinGW
+  Trace::SetCurrentThreadName(name);
 }
 
 void SetThreadName(void *thread, const std::string_view &name) {
@@ -192,6 +203,184 @@ void SetThreadName(void *thread, const std::string_view &name) {
 
 #endif
 
+#if defined(__linux__)
+
+// Not in glibc, mbind/set_mempolicy are normally reached through libnuma
+static constexpr int MPOL_PREFERRED_ = 1;
+static constexpr unsigned MPOL_MF_MOVE_ = 1 << 1;
+// Node masks passed to the kernel, large enough for any realistic machine
+static constexpr size_t NUMA_MASK_BITS = 1024;
+
+static std::string ReadSysFile(const std::string &path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+// Parses kernel range lists such as "0-7,16-23".
+static std::vector<u32> ParseRangeList(const std::string &list) {
+  std::vector<u32> values;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    const size_t comma = std::min(list.find(',', pos), list.size());
+    const std::string range = list.substr(pos, comma - pos);
+    const size_t dash = range.find('-');
+    const u32 first = static_cast<u32>(std::strtoul(range.c_str(), nullptr, 10));
+    const u32 last = dash == std::string::npos ?
+      first : static_cast<u32>(std::strtoul(range.c_str() + dash + 1, nullptr, 10));
+    for (u32 value = first; value <= last; value++) {
+      values.push_back(value);
+    }
+    pos = comma + 1;
+  }
+  return values;
+}
+
+static bool IsValidNumaNode(s32 node) {
+  return node >= 0 && node < GetNumaNodeCount() && static_cast<size_t>(node) < NUMA_MASK_BITS;
+}
+
+s32 GetNumaNodeCount() {
+  static const s32 count = [] {
+    const std::vector<u32> nodes = ParseRangeList(ReadSysFile("/sys/devices/system/node/online"));
+    return nodes.empty() ? 1 : static_cast<s32>(nodes.back() + 1);
+  }();
+  return count;
+}
+
+s32 GetCurrentNumaNode() {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return static_cast<s32>(node);
+}
+
+bool SetCurrentThreadNumaNode(s32 node) {
+  if (!IsValidNumaNode(node)) {
+    return false;
+  }
+  const std::vector<u32> cpus =
+    ParseRangeList(ReadSysFile(fmt::format("/sys/devices/system/node/node{}/cpulist", node)));
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const u32 cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    LOG_WARNING(Base, "Could not bind thread to NUMA node {}: {}", node, std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool SetCurrentThreadMemoryNode(s32 node) {
+  if (!IsValidNumaNode(node)) {
+    return false;
+  }
+  unsigned long mask[NUMA_MASK_BITS / 64] = {};
+  mask[node / 64] = 1UL << (node % 64);
+  // The kernel ignores the last bit of maxnode, hence the + 1
+  if (syscall(SYS_set_mempolicy, MPOL_PREFERRED_, mask, NUMA_MASK_BITS + 1) != 0) {
+    LOG_WARNING(Base, "Could not set the memory policy to NUMA node {}: {}", node,
+                std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool BindMemoryToNumaNode(void *address, size_t size, s32 node) {
+  if (!IsValidNumaNode(node)) {
+    return false;
+  }
+  unsigned long mask[NUMA_MASK_BITS / 64] = {};
+  mask[node / 64] = 1UL << (node % 64);
+  if (syscall(SYS_mbind, address, size, MPOL_PREFERRED_, mask, NUMA_MASK_BITS + 1,
+              MPOL_MF_MOVE_) != 0) {
+    LOG_WARNING(Base, "Could not bind {} bytes at {} to NUMA node {}: {}", size,
+                fmt::ptr(address), node, std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+#elif defined(_WIN32)
+
+s32 GetNumaNodeCount() {
+  ULONG highest = 0;
+  if (!GetNumaHighestNodeNumber(&highest)) {
+    return 1;
+  }
+  return static_cast<s32>(highest + 1);
+}
+
+s32 GetCurrentNumaNode() {
+  PROCESSOR_NUMBER processor{};
+  GetCurrentProcessorNumberEx(&processor);
+  USHORT node = 0;
+  if (!GetNumaProcessorNodeEx(&processor, &node)) {
+    return 0;
+  }
+  return static_cast<s32>(node);
+}
+
+bool SetCurrentThreadNumaNode(s32 node) {
+  if (node < 0 || node >= GetNumaNodeCount()) {
+    return false;
+  }
+  GROUP_AFFINITY affinity{};
+  if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity) ||
+      !SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr)) {
+    LOG_WARNING(Base, "Could not bind thread to NUMA node {}: {}", node, GetLastError());
+    return false;
+  }
+  return true;
+}
+
+bool SetCurrentThreadMemoryNode(s32 node) {
+  // Windows already prefers the node of the processor a thread runs on when it first
+  // touches a page, so binding the thread with SetCurrentThreadNumaNode() is enough.
+  return node >= 0 && node < GetNumaNodeCount();
+}
+
+bool BindMemoryToNumaNode([[maybe_unused]] void *address, [[maybe_unused]] size_t size,
+                          [[maybe_unused]] s32 node) {
+  // Only VirtualAllocExNuma can choose a node, and only for new allocations
+  return false;
+}
+
+#else
+
+s32 GetNumaNodeCount() {
+  return 1;
+}
+
+s32 GetCurrentNumaNode() {
+  return 0;
+}
+
+bool SetCurrentThreadNumaNode([[maybe_unused]] s32 node) {
+  return false;
+}
+
+bool SetCurrentThreadMemoryNode([[maybe_unused]] s32 node) {
+  return false;
+}
+
+bool BindMemoryToNumaNode([[maybe_unused]] void *address, [[maybe_unused]] size_t size,
+                          [[maybe_unused]] s32 node) {
+  return false;
+}
+
+#endif
+
 AccurateTimer::AccurateTimer(std::chrono::nanoseconds target_interval) :
   target_interval(target_interval)
 {}
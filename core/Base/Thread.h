@@ -22,6 +22,25 @@ void SetCurrentThreadName(const std::string_view &name);
 
 void SetThreadName(void *thread, const std::string_view &name);
 
+// NUMA placement. Hosts without NUMA support report a single node 0, and the functions
+// changing placement return false there.
+
+// Returns the number of NUMA nodes of the host.
+s32 GetNumaNodeCount();
+
+// Returns the node of the CPU the calling thread is running on.
+s32 GetCurrentNumaNode();
+
+// Restricts the calling thread to the CPUs of `node`.
+bool SetCurrentThreadNumaNode(s32 node);
+
+// Makes memory first touched by the calling thread prefer `node` from now on.
+bool SetCurrentThreadMemoryNode(s32 node);
+
+// Makes the pages of [address, address + size) prefer `node`, migrating the ones already
+// allocated elsewhere. The range must be page aligned.
+bool BindMemoryToNumaNode(void *address, size_t size, s32 node);
+
 class AccurateTimer {
   std::chrono::nanoseconds target_interval{};
   std::chrono::nanoseconds total_wait{};
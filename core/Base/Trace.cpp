@@ -0,0 +1,195 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Base/IoFile.h"
+#include "Base/Logging/Log.h"
+#include "Base/PolyfillThread.h"
+#include "Base/Thread.h"
+
+#include "Trace.h"
+
+namespace Base {
+namespace Trace {
+
+namespace Detail {
+std::atomic<bool> enabled = false;
+} // namespace Detail
+
+namespace {
+
+struct Event {
+  const char *name;
+  u64 begin;
+  u64 end;
+};
+
+/*
+ * Zones of one thread. The thread is the only writer and the trace writer thread the only reader,
+ * so the ring needs no locks. Buffers live until the process exits, the thread owning one may
+ * still be recording into it after a trace stopped.
+ */
+struct ThreadBuffer {
+  static constexpr size_t Capacity = 0x4000;
+
+  alignas(128) std::atomic<size_t> readIndex = 0;
+  alignas(128) std::atomic<size_t> writeIndex = 0;
+  std::atomic<u64> dropped = 0;
+  std::array<Event, Capacity> events;
+
+  u32 tid = 0;
+  // Set by the owning thread, read by the writer under registryMutex
+  std::string name;
+  // Writer side, whether the thread name was written to the current trace
+  bool named = false;
+};
+
+// How often the writer thread moves recorded zones to the file
+constexpr auto WriteInterval = std::chrono::milliseconds(100);
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+thread_local ThreadBuffer *currentBuffer = nullptr;
+thread_local std::string currentThreadName;
+
+// Owned by Start()/Stop() and the writer thread
+Base::FS::IOFile file;
+std::jthread writerThread;
+std::string output;
+u64 origin = 0;
+u64 reportedDrops = 0;
+
+ThreadBuffer *RegisterThread() {
+  auto buffer = std::make_unique<ThreadBuffer>();
+  currentBuffer = buffer.get();
+  std::scoped_lock lock{registryMutex};
+  buffer->tid = static_cast<u32>(buffers.size() + 1);
+  buffer->name = currentThreadName.empty() ? fmt::format("Thread {}", buffer->tid)
+                                           : currentThreadName;
+  buffers.push_back(std::move(buffer));
+  return currentBuffer;
+}
+
+void AppendTime(u64 nanoseconds) {
+  // Trace event times are in microseconds
+  fmt::format_to(std::back_inserter(output), "{}.{:03}", nanoseconds / 1000, nanoseconds % 1000);
+}
+
+// Moves the zones recorded so far from every thread ring into the file.
+void WriteEvents() {
+  std::scoped_lock lock{registryMutex};
+  u64 dropped = 0;
+  for (const auto &buffer : buffers) {
+    if (!buffer->named) {
+      fmt::format_to(std::back_inserter(output),
+                     ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                     "\"args\":{{\"name\":\"{}\"}}}}", buffer->tid, buffer->name);
+      buffer->named = true;
+    }
+    const size_t end = buffer->writeIndex.load(std::memory_order_acquire);
+    for (size_t index = buffer->readIndex.load(std::memory_order_relaxed); index != end; index++) {
+      const Event &event = buffer->events[index % ThreadBuffer::Capacity];
+      if (event.begin < origin) {
+        // Opened before this trace started
+        continue;
+      }
+      fmt::format_to(std::back_inserter(output),
+                     ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":",
+                     event.name, buffer->tid);
+      AppendTime(event.begin - origin);
+      output.append(",\"dur\":");
+      AppendTime(event.end - event.begin);
+      output.push_back('}');
+    }
+    buffer->readIndex.store(end, std::memory_order_release);
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  file.WriteString(output);
+  output.clear();
+
+  if (dropped != reportedDrops) {
+    LOG_WARNING(Debug, "Trace buffers full, {} zones dropped so far", dropped);
+    reportedDrops = dropped;
+  }
+}
+
+} // namespace
+
+bool Start(const std::filesystem::path &path) {
+  Stop();
+  file.Open(path, Base::FS::FileAccessMode::Write, Base::FS::FileMode::TextMode);
+  if (!file.IsOpen()) {
+    LOG_ERROR(Debug, "Failed to open trace file {}", path.string());
+    return false;
+  }
+
+  {
+    // Forget whatever was recorded after the last trace stopped
+    std::scoped_lock lock{registryMutex};
+    for (const auto &buffer : buffers) {
+      buffer->readIndex.store(buffer->writeIndex.load(std::memory_order_acquire),
+                              std::memory_order_release);
+      buffer->dropped = 0;
+      buffer->named = false;
+    }
+  }
+  reportedDrops = 0;
+  origin = Now();
+  // Every later event is written with a leading comma
+  output = "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Pound\"}}";
+
+  Detail::enabled = true;
+  writerThread = std::jthread([](std::stop_token stopToken) {
+    Base::SetCurrentThreadName("[Xe] Trace");
+    while (StoppableTimedWait(stopToken, WriteInterval)) {
+      WriteEvents();
+    }
+  });
+  LOG_INFO(Debug, "Writing trace to {}", path.string());
+  return true;
+}
+
+void Stop() {
+  if (!writerThread.joinable()) {
+    return;
+  }
+  Detail::enabled = false;
+  writerThread.request_stop();
+  writerThread.join();
+  // Zones still open when tracing stopped are not recorded any more
+  WriteEvents();
+  file.WriteString(std::string_view("\n]\n"));
+  file.Close();
+}
+
+void SetCurrentThreadName(std::string_view name) {
+  currentThreadName = name;
+  if (currentBuffer) {
+    std::scoped_lock lock{registryMutex};
+    currentBuffer->name = currentThreadName;
+  }
+}
+
+u64 Now() {
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Record(const char *name, u64 begin, u64 end) {
+  ThreadBuffer *buffer = currentBuffer ? currentBuffer : RegisterThread();
+  const size_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+  if (index - buffer->readIndex.load(std::memory_order_acquire) == ThreadBuffer::Capacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->events[index % ThreadBuffer::Capacity] = { name, begin, end };
+  buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+} // namespace Trace
+} // namespace Base
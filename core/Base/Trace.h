@@ -0,0 +1,74 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <string_view>
+
+/*
+ * Scoped timing zones, written as Chrome trace event JSON that chrome://tracing and the Perfetto
+ * UI open directly.
+ *
+ * Every thread records its zones into its own lock-free ring and a writer thread drains the rings
+ * to the file in the background, so a zone costs two clock reads and a store into the ring. When
+ * no trace is running a zone only checks a flag. Events that don't fit in a full ring are
+ * dropped and counted.
+ */
+namespace Base {
+namespace Trace {
+
+namespace Detail {
+extern std::atomic<bool> enabled;
+} // namespace Detail
+
+/// Starts recording zones into `path`, replacing it. Returns false if the file can't be opened.
+bool Start(const std::filesystem::path &path);
+
+/// Writes out the zones recorded so far and closes the trace.
+void Stop();
+
+inline bool IsEnabled() {
+  return Detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// Names the calling thread in traces, called by Base::SetCurrentThreadName.
+void SetCurrentThreadName(std::string_view name);
+
+/// Nanoseconds on the steady clock, the time base of zones.
+u64 Now();
+
+/// Records a zone of the calling thread. `name` must outlive the trace, zones use literals.
+void Record(const char *name, u64 begin, u64 end);
+
+class Zone {
+public:
+  template <size_t N>
+  explicit Zone(const char (&name_)[N]) : name(name_) {
+    if (IsEnabled()) {
+      begin = Now();
+    }
+  }
+
+  ~Zone() {
+    if (begin != 0) {
+      Record(name, begin, Now());
+    }
+  }
+
+  Zone(const Zone&) = delete;
+  Zone& operator=(const Zone&) = delete;
+
+private:
+  const char *name;
+  u64 begin = 0;
+};
+
+} // namespace Trace
+} // namespace Base
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+/// Times the rest of the enclosing scope as a zone called `name`, a string literal.
+#define SCOPED_TRACE(name) const Base::Trace::Zone TRACE_CONCAT(traceZone_, __LINE__){name}
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <array>
+
 #include <fmt/format.h>
 
 #include "Arch.h"
@@ -19,6 +21,7 @@ using u16 = unsigned short;
 using u32 = unsigned int;
 using ul32 = unsigned long;
 using u64 = unsigned long long;
+using u128 = std::array<u64, 2>;
 
 using uptr = uintptr_t;
 
@@ -1,50 +1,110 @@
 // Copyright 2025 Pound Emulator Project. All rights reserved.
 
 #include "jit.h"
+#include "Base/Assert.h"
+#include "Base/Thread.h"
+#include "Base/Trace.h"
+#include "memory/host_memory.h"
 
 #include <rem.h>
 
-#ifdef WIN32
-#include <Windows.h>
-#else
-#include <sys/mman.h>
-#endif
-
+#include <memory_resource>
 #include <vector>
 
 using JitFunc = void (*)();
 
-void JIT::translate_and_run(CPU& cpu) {
+JIT::JIT() {
+    code_cache = static_cast<u8*>(Memory::host_map(
+        CODE_CACHE_SIZE, HOST_PROT_READ | HOST_PROT_WRITE | HOST_PROT_EXEC, true));
+    ASSERT_MSG(code_cache != nullptr, "Failed to map the JIT code cache");
 
-    // TODO: Create REM Context
-    create_rem_context(nullptr, nullptr, nullptr, nullptr, nullptr);
+    translation_arena = Memory::arena_create(TRANSLATION_ARENA_RESERVE, Memory::ARENA_MODE_RESERVE);
+    ASSERT_MSG(translation_arena.data != nullptr, "Failed to reserve the JIT translation arena");
+    translation_arena.stats = Memory::alloc_stats_get("jit translation");
+}
 
-#ifdef WIN32
-    u8* code = (u8*)VirtualAlloc(NULL, 64, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
-#else
-    u8* code = (u8*)mmap(nullptr, 64, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANON, -1, 0);
-#endif
+JIT::~JIT() {
+    Memory::arena_free(&translation_arena);
+    Memory::host_unmap(code_cache, CODE_CACHE_SIZE, true);
+}
 
-    size_t offset = 0;
+bool JIT::bind_to_numa_node(s32 node) {
+    return Base::BindMemoryToNumaNode(code_cache, CODE_CACHE_SIZE, node);
+}
+
+u8* JIT::allocate_code(size_t size) {
+    if (size > CODE_CACHE_SIZE - code_cache_used) {
+        // Nothing can still be running from the cache between blocks, so just start over
+        code_cache_used = 0;
+    }
+    u8* code = code_cache + code_cache_used;
+    code_cache_used += size;
+    return code;
+}
+
+namespace {
+
+enum class Opcode {
+    MovImm,
+    AddImm,
+};
 
+struct DecodedInstruction {
+    Opcode opcode;
+    u64 imm;
+};
+
+}  // namespace
+
+u8* JIT::translate(CPU& cpu) {
+    SCOPED_TRACE("JIT::translate");
     // Decode mock instructions from cpu.memory
+    std::pmr::vector<DecodedInstruction> instructions(&translation_resource);
     if (cpu.memory[0] == 0x05) { // MOVZ placeholder
-        code[offset++] = 0x48;   // mov rax, imm64
-        code[offset++] = 0xB8;
-        u64 imm = 5;
-        std::memcpy(&code[offset], &imm, sizeof(imm));
-        offset += 8;
+        instructions.push_back({Opcode::MovImm, 5});
     }
-
     if (cpu.memory[4] == 0x03) { // ADD placeholder
-        code[offset++] = 0x48;   // add rax, imm32
-        code[offset++] = 0x05;
-        u32 addval = 3;
-        std::memcpy(&code[offset], &addval, sizeof(addval));
-        offset += 4;
+        instructions.push_back({Opcode::AddImm, 3});
+    }
+
+    u8* code = allocate_code(MAX_BLOCK_SIZE);
+    size_t offset = 0;
+
+    for (const DecodedInstruction& instruction : instructions) {
+        switch (instruction.opcode) {
+        case Opcode::MovImm: {
+            code[offset++] = 0x48; // mov rax, imm64
+            code[offset++] = 0xB8;
+            const u64 imm = instruction.imm;
+            std::memcpy(&code[offset], &imm, sizeof(imm));
+            offset += 8;
+            break;
+        }
+        case Opcode::AddImm: {
+            code[offset++] = 0x48; // add rax, imm32
+            code[offset++] = 0x05;
+            const u32 addval = static_cast<u32>(instruction.imm);
+            std::memcpy(&code[offset], &addval, sizeof(addval));
+            offset += 4;
+            break;
+        }
+        }
     }
 
     code[offset++] = 0xC3; // ret
+    // Give back the unused tail of the block reservation
+    code_cache_used -= MAX_BLOCK_SIZE - offset;
+    return code;
+}
+
+void JIT::translate_and_run(CPU& cpu) {
+    SCOPED_TRACE("JIT::translate_and_run");
+    // TODO: Create REM Context
+    create_rem_context(nullptr, nullptr, nullptr, nullptr, nullptr);
+
+    u8* code = translate(cpu);
+    // The block is in the code cache, every translation temporary is dead now
+    Memory::arena_reset(&translation_arena);
 
     JitFunc fn = reinterpret_cast<JitFunc>(code);
     u64 result;
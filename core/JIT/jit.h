@@ -3,8 +3,38 @@
 #pragma once
 
 #include "ARM/cpu.h"
+#include "memory/arena.h"
 
 class JIT {
 public:
+    JIT();
+    ~JIT();
+
+    JIT(const JIT&) = delete;
+    JIT& operator=(const JIT&) = delete;
+
     void translate_and_run(CPU& cpu);
+
+    // Moves the code cache to `node`, see Base::BindMemoryToNumaNode.
+    bool bind_to_numa_node(s32 node);
+
+private:
+    // Host code is emitted into one executable region, mapped once and reused from the
+    // start when it fills up.
+    static constexpr size_t CODE_CACHE_SIZE = 16 * 1024 * 1024;
+    // Upper bound on the host code emitted for one block
+    static constexpr size_t MAX_BLOCK_SIZE = 64;
+    // Address space reserved for translation temporaries, only the part in use is committed
+    static constexpr size_t TRANSLATION_ARENA_RESERVE = 64 * 1024 * 1024;
+
+    u8* allocate_code(size_t size);
+    u8* translate(CPU& cpu);
+
+    u8* code_cache = nullptr;
+    size_t code_cache_used = 0;
+
+    // Every temporary built while translating a block lives here, and the whole arena is reset
+    // once the block is in the code cache instead of freeing objects one by one.
+    Memory::Arena translation_arena = {};
+    Memory::ArenaResource translation_resource{&translation_arena};
 };
@@ -0,0 +1,184 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include "replay.h"
+
+#include <cstring>
+#include <vector>
+
+#include "Base/IoFile.h"
+#include "Base/Logging/Log.h"
+
+namespace Kernel::Replay {
+
+static constexpr char MAGIC[4] = {'P', 'R', 'P', 'L'};
+static constexpr u32 VERSION = 1;
+static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+static Mode current_mode = Mode::Off;
+static Base::FS::IOFile record_file;
+static std::vector<u8> buffer;
+static size_t read_pos = 0;
+
+static void flush_recording() {
+    if (!buffer.empty()) {
+        record_file.WriteSpan(std::span<const u8>(buffer));
+        buffer.clear();
+    }
+}
+
+static void put_varint(u64 value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<u8>(value) | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<u8>(value));
+}
+
+static bool get_varint(u64& value) {
+    value = 0;
+    for (u32 shift = 0; shift < 64 && read_pos < buffer.size(); shift += 7) {
+        const u8 byte = buffer[read_pos++];
+        value |= static_cast<u64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replay has diverged from the recording, keep running with live values from here on.
+static void desync(Event expected) {
+    LOG_CRITICAL(System, "Replay desynchronized at offset {} (expected event {})", read_pos,
+                 static_cast<u8>(expected));
+    stop();
+}
+
+// Consumes the header of the next record, checking it is of the expected type.
+static bool next_record(Event event) {
+    if (read_pos >= buffer.size()) {
+        LOG_INFO(System, "Replay finished");
+        stop();
+        return false;
+    }
+    if (buffer[read_pos] != static_cast<u8>(event)) {
+        desync(event);
+        return false;
+    }
+    ++read_pos;
+    return true;
+}
+
+bool start_recording(const std::filesystem::path& path) {
+    stop();
+    record_file.Open(path, Base::FS::FileAccessMode::Write);
+    if (!record_file.IsOpen()) {
+        LOG_ERROR(System, "Failed to open replay file {} for writing", path.string());
+        return false;
+    }
+    buffer.assign(std::begin(MAGIC), std::end(MAGIC));
+    buffer.resize(sizeof(MAGIC) + sizeof(VERSION));
+    std::memcpy(&buffer[sizeof(MAGIC)], &VERSION, sizeof(VERSION));
+    current_mode = Mode::Record;
+    LOG_INFO(System, "Recording guest inputs to {}", path.string());
+    return true;
+}
+
+bool start_replay(const std::filesystem::path& path) {
+    stop();
+    Base::FS::IOFile file(path, Base::FS::FileAccessMode::Read);
+    if (!file.IsOpen()) {
+        LOG_ERROR(System, "Failed to open replay file {}", path.string());
+        return false;
+    }
+    buffer.resize(file.GetSize());
+    file.ReadSpan(std::span<u8>(buffer));
+
+    u32 version = 0;
+    if (buffer.size() < sizeof(MAGIC) + sizeof(version) ||
+        std::memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        LOG_ERROR(System, "{} is not a replay file", path.string());
+        buffer.clear();
+        return false;
+    }
+    std::memcpy(&version, &buffer[sizeof(MAGIC)], sizeof(version));
+    if (version != VERSION) {
+        LOG_ERROR(System, "Unsupported replay version {}", version);
+        buffer.clear();
+        return false;
+    }
+    read_pos = sizeof(MAGIC) + sizeof(version);
+    current_mode = Mode::Replay;
+    LOG_INFO(System, "Replaying guest inputs from {}", path.string());
+    return true;
+}
+
+void stop() {
+    if (current_mode == Mode::Record) {
+        flush_recording();
+        record_file.Close();
+    }
+    current_mode = Mode::Off;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    read_pos = 0;
+}
+
+Mode mode() {
+    return current_mode;
+}
+
+u64 value(Event event, u64 live_value) {
+    switch (current_mode) {
+    case Mode::Off:
+        return live_value;
+    case Mode::Record:
+        buffer.push_back(static_cast<u8>(event));
+        put_varint(live_value);
+        if (buffer.size() >= FLUSH_THRESHOLD) {
+            flush_recording();
+        }
+        return live_value;
+    case Mode::Replay: {
+        u64 recorded = 0;
+        if (!next_record(event)) {
+            return live_value;
+        }
+        if (!get_varint(recorded)) {
+            desync(event);
+            return live_value;
+        }
+        return recorded;
+    }
+    }
+    return live_value;
+}
+
+void bytes(Event event, std::span<u8> data) {
+    switch (current_mode) {
+    case Mode::Off:
+        return;
+    case Mode::Record:
+        buffer.push_back(static_cast<u8>(event));
+        put_varint(data.size());
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        if (buffer.size() >= FLUSH_THRESHOLD) {
+            flush_recording();
+        }
+        return;
+    case Mode::Replay: {
+        u64 size = 0;
+        if (!next_record(event)) {
+            return;
+        }
+        if (!get_varint(size) || size != data.size() || buffer.size() - read_pos < size) {
+            desync(event);
+            return;
+        }
+        std::memcpy(data.data(), &buffer[read_pos], size);
+        read_pos += size;
+        return;
+    }
+    }
+}
+
+}  // namespace Kernel::Replay
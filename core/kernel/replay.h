@@ -0,0 +1,47 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+// Deterministic record/replay of guest execution.
+//
+// Every nondeterministic input handed to the guest (timer reads, controller input, HLE service
+// results, scheduling decisions) is passed through this module. While recording, the value is
+// appended to a compact binary log; while replaying, the logged value is returned instead of the
+// live one, so the guest executes the exact same instruction stream on every run.
+//
+// Log format: the magic "PRPL", a u32 version, then one record per input. A record is the event
+// byte followed by a LEB128 encoded value, or by a LEB128 length and the raw bytes for buffers.
+namespace Kernel::Replay {
+
+enum class Mode {
+    Off,
+    Record,
+    Replay,
+};
+
+enum class Event : u8 {
+    Timer,
+    Input,
+    ServiceResult,
+    Schedule,
+    Count,
+};
+
+bool start_recording(const std::filesystem::path& path);
+bool start_replay(const std::filesystem::path& path);
+
+// Flushes the recording (if any) and returns to Mode::Off.
+void stop();
+
+Mode mode();
+
+// Returns `live_value` when off or recording, and the recorded value when replaying.
+u64 value(Event event, u64 live_value);
+
+// Same as value() for a buffer, which is overwritten with the recorded contents when replaying.
+void bytes(Event event, std::span<u8> data);
+
+}  // namespace Kernel::Replay
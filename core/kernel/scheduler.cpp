@@ -0,0 +1,118 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include "scheduler.h"
+
+#include <algorithm>
+
+#include "Base/Assert.h"
+#include "Base/Thread.h"
+#include "Base/Trace.h"
+#include "replay.h"
+
+namespace Kernel {
+
+Scheduler::Scheduler(CPU& cpu) : cpu(cpu) {}
+
+Scheduler::~Scheduler() = default;
+
+u64 Scheduler::create_thread(std::function<void()> entry, u64 entry_pc) {
+    Memory::SlabPtr<GuestThread> thread{Memory::slab_new<GuestThread>()};
+    ASSERT_MSG(thread != nullptr, "Failed to allocate a guest thread");
+    GuestThread* raw = thread.get();
+    raw->id = next_thread_id++;
+    raw->context.pc = entry_pc;
+    raw->fiber = std::make_unique<Base::Fiber>([this, raw, entry = std::move(entry)] {
+        entry();
+        raw->state = ThreadState::Exited;
+        // Exited threads are destroyed by the host fiber, never resume this one.
+        Base::Fiber::YieldTo(*raw->fiber, *host_fiber);
+        UNREACHABLE();
+    });
+
+    threads.push_back(std::move(thread));
+    ready_queue.push_back(raw);
+    return raw->id;
+}
+
+void Scheduler::run() {
+    ASSERT_MSG(current == nullptr, "Scheduler::run called from a guest thread");
+    SCOPED_TRACE("Scheduler::run");
+    apply_numa_placement();
+    host_fiber = Base::Fiber::ThreadToFiber();
+
+    while (!ready_queue.empty()) {
+        GuestThread* next = pop_next_ready();
+
+        cpu.set_state(next->context.regs, next->context.pc);
+        next->state = ThreadState::Running;
+        current = next;
+        Base::Fiber::YieldTo(*host_fiber, *next->fiber);
+
+        // We only get back here once a thread exits.
+        current = nullptr;
+        reap_exited_threads();
+    }
+
+    host_fiber.reset();
+    // The host thread goes idle, hand objects it freed for other threads to their owners
+    Memory::slab_flush_remote();
+}
+
+void Scheduler::yield() {
+    ASSERT_MSG(current != nullptr, "Scheduler::yield called outside of a guest thread");
+    if (ready_queue.empty()) {
+        return;
+    }
+
+    GuestThread* next = pop_next_ready();
+    current->state = ThreadState::Ready;
+    ready_queue.push_back(current);
+    switch_to(next);
+}
+
+// Done before any guest thread runs, so the memory they first touch lands on the node too.
+void Scheduler::apply_numa_placement() {
+    if (numa_node < 0 || Base::GetNumaNodeCount() < 2) {
+        return;
+    }
+    if (!Base::SetCurrentThreadNumaNode(numa_node)) {
+        return;
+    }
+    Base::SetCurrentThreadMemoryNode(numa_node);
+    cpu.bind_to_numa_node(numa_node);
+    LOG_INFO(System, "Guest execution bound to NUMA node {}", numa_node);
+}
+
+GuestThread* Scheduler::pop_next_ready() {
+    SCOPED_TRACE("Scheduler::pop_next_ready");
+    // The choice goes through the replay log so that a replayed run schedules identically.
+    const u64 id = Replay::value(Replay::Event::Schedule, ready_queue.front()->id);
+    auto it = std::find_if(ready_queue.begin(), ready_queue.end(),
+                           [id](const GuestThread* thread) { return thread->id == id; });
+    if (it == ready_queue.end()) {
+        LOG_ERROR(System, "Recorded thread {} is not ready, scheduling in order", id);
+        it = ready_queue.begin();
+    }
+    GuestThread* next = *it;
+    ready_queue.erase(it);
+    return next;
+}
+
+void Scheduler::switch_to(GuestThread* next) {
+    GuestThread* previous = current;
+    cpu.get_state(previous->context.regs, previous->context.pc);
+    cpu.set_state(next->context.regs, next->context.pc);
+
+    next->state = ThreadState::Running;
+    current = next;
+    Base::Fiber::YieldTo(*previous->fiber, *next->fiber);
+}
+
+void Scheduler::reap_exited_threads() {
+    SCOPED_TRACE("Scheduler::reap_exited_threads");
+    std::erase_if(threads, [](const Memory::SlabPtr<GuestThread>& thread) {
+        return thread->state == ThreadState::Exited;
+    });
+}
+
+}  // namespace Kernel
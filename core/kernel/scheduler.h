@@ -0,0 +1,82 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ARM/cpu.h"
+#include "Base/Fiber.h"
+#include "memory/slab.h"
+
+namespace Kernel {
+
+// Guest register state swapped in and out of the CPU on a context switch.
+struct ThreadContext {
+    u64 regs[31] = {0};
+    u64 pc = 0;
+};
+
+enum class ThreadState {
+    Ready,
+    Running,
+    Exited,
+};
+
+struct GuestThread {
+    u64 id = 0;
+    ThreadState state = ThreadState::Ready;
+    ThreadContext context;
+    std::unique_ptr<Base::Fiber> fiber;
+};
+
+// Cooperative scheduler running every guest thread on a fiber of the calling host thread.
+// A context switch only swaps the CPU register state and the fiber stack, so it never blocks
+// or wakes up a host thread.
+class Scheduler {
+public:
+    explicit Scheduler(CPU& cpu);
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Creates a ready guest thread which starts executing `entry` with the PC set to `entry_pc`.
+    // The thread exits when `entry` returns.
+    u64 create_thread(std::function<void()> entry, u64 entry_pc = 0);
+
+    // Runs guest threads on the calling host thread until all of them have exited.
+    void run();
+
+    // Makes run() pin its host thread to the CPUs of `node`, and keep guest memory and memory
+    // first touched by the thread on that node. -1 (the default) leaves placement to the host.
+    void set_numa_node(s32 node) {
+        numa_node = node;
+    }
+
+    // Called from a guest thread to hand the CPU to the next ready thread.
+    void yield();
+
+    GuestThread* current_thread() {
+        return current;
+    }
+
+private:
+    GuestThread* pop_next_ready();
+    void switch_to(GuestThread* next);
+    void reap_exited_threads();
+    void apply_numa_placement();
+
+    CPU& cpu;
+    // Guest threads are created and destroyed while a title runs, so they come from a slab
+    std::vector<Memory::SlabPtr<GuestThread>> threads;
+    std::deque<GuestThread*> ready_queue;
+    GuestThread* current = nullptr;
+    std::unique_ptr<Base::Fiber> host_fiber;
+    u64 next_thread_id = 1;
+    s32 numa_node = -1;
+};
+
+}  // namespace Kernel
@@ -0,0 +1,250 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include "vm_manager.h"
+
+#include <vector>
+
+#include "ARM/cpu.h"
+#include "Base/Assert.h"
+#include "memory/host_memory.h"
+
+namespace Kernel {
+
+// Guest execute permission only matters to the JIT, fastmem only ever reads and writes.
+static int host_protection(MemoryPermission permission) {
+    int prot = 0;
+    if (True(permission & (MemoryPermission::Read | MemoryPermission::Execute))) {
+        prot |= HOST_PROT_READ;
+    }
+    if (True(permission & MemoryPermission::Write)) {
+        prot |= HOST_PROT_WRITE;
+    }
+    return prot;
+}
+
+bool VirtualMemoryArea::can_merge_with(const VirtualMemoryArea& next) const {
+    ASSERT(base + size == next.base);
+    if (state != next.state || permission != next.permission) {
+        return false;
+    }
+    return state == MemoryState::Free || physical_base + size == next.physical_base;
+}
+
+VMManager::VMManager(u64 address_space_size, const Memory::MemoryView* view,
+                     const Memory::PhysicalMemory* physical)
+    : address_space_size(address_space_size), view(view), physical(physical) {
+    ASSERT(view == nullptr || (physical != nullptr && view->size >= address_space_size));
+    vmas.emplace(0, VirtualMemoryArea{.base = 0, .size = address_space_size});
+}
+
+MemoryResult VMManager::map(u64 address, u64 size, u64 physical_address, MemoryState state,
+                            MemoryPermission permission) {
+    if (const MemoryResult result = check_range(address, size); result != MemoryResult::Success) {
+        return result;
+    }
+    ASSERT(state != MemoryState::Free && state != MemoryState::Inaccessible);
+    if (physical != nullptr &&
+        (physical_address > physical->size || size > physical->size - physical_address)) {
+        return MemoryResult::InvalidAddress;
+    }
+    if (!is_free(address, size)) {
+        return MemoryResult::InvalidCurrentMemory;
+    }
+
+    if (view != nullptr && !Memory::view_map(view, address, physical, physical_address, size,
+                                             host_protection(permission))) {
+        return MemoryResult::HostMappingFailed;
+    }
+
+    VirtualMemoryArea& vma = carve_range(address, size)->second;
+    vma.state = state;
+    vma.permission = permission;
+    vma.physical_base = physical_address;
+    coalesce(address, size);
+    return MemoryResult::Success;
+}
+
+MemoryResult VMManager::map_alias(u64 dst, u64 src, u64 size) {
+    if (const MemoryResult result = check_range(dst, size); result != MemoryResult::Success) {
+        return result;
+    }
+    if (const MemoryResult result = check_range(src, size); result != MemoryResult::Success) {
+        return result;
+    }
+    if (!is_mapped(src, size) || !is_free(dst, size)) {
+        return MemoryResult::InvalidCurrentMemory;
+    }
+
+    // The source may span several VMAs with unrelated backing, alias each piece separately
+    struct Piece {
+        u64 offset;
+        u64 size;
+        u64 physical_base;
+        MemoryPermission permission;
+    };
+    std::vector<Piece> pieces;
+    for (auto it = find_vma(src); it != vmas.end() && it->first < src + size; ++it) {
+        const VirtualMemoryArea& vma = it->second;
+        const u64 start = std::max(vma.base, src);
+        const u64 end = std::min(vma.base + vma.size, src + size);
+        pieces.push_back({start - src, end - start, vma.physical_base + (start - vma.base),
+                          vma.permission});
+    }
+
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        const Piece& piece = pieces[i];
+        const MemoryResult result = map(dst + piece.offset, piece.size, piece.physical_base,
+                                        MemoryState::Alias, piece.permission);
+        if (result != MemoryResult::Success) {
+            // Leave the destination as we found it
+            if (piece.offset != 0) {
+                unmap(dst, piece.offset);
+            }
+            return result;
+        }
+    }
+    return MemoryResult::Success;
+}
+
+MemoryResult VMManager::unmap(u64 address, u64 size) {
+    if (const MemoryResult result = check_range(address, size); result != MemoryResult::Success) {
+        return result;
+    }
+    if (view != nullptr && !Memory::view_unmap(view, address, size)) {
+        return MemoryResult::HostMappingFailed;
+    }
+
+    for (auto it = carve_range(address, size); it != vmas.end() && it->first < address + size;
+         ++it) {
+        it->second.state = MemoryState::Free;
+        it->second.permission = MemoryPermission::None;
+        it->second.physical_base = 0;
+    }
+    coalesce(address, size);
+    return MemoryResult::Success;
+}
+
+MemoryResult VMManager::protect(u64 address, u64 size, MemoryPermission permission) {
+    if (const MemoryResult result = check_range(address, size); result != MemoryResult::Success) {
+        return result;
+    }
+    if (!is_mapped(address, size)) {
+        return MemoryResult::InvalidCurrentMemory;
+    }
+    if (view != nullptr &&
+        !Memory::view_protect(view, address, size, host_protection(permission))) {
+        return MemoryResult::HostMappingFailed;
+    }
+
+    for (auto it = carve_range(address, size); it != vmas.end() && it->first < address + size;
+         ++it) {
+        it->second.permission = permission;
+    }
+    coalesce(address, size);
+    return MemoryResult::Success;
+}
+
+MemoryInfo VMManager::query(u64 address) const {
+    if (address >= address_space_size) {
+        return {
+            .base = address_space_size,
+            .size = ~address_space_size + 1,
+            .state = MemoryState::Inaccessible,
+            .permission = MemoryPermission::None,
+        };
+    }
+    const VirtualMemoryArea& vma = find_vma(address)->second;
+    return {
+        .base = vma.base,
+        .size = vma.size,
+        .state = vma.state,
+        .permission = vma.permission,
+    };
+}
+
+MemoryResult VMManager::check_range(u64 address, u64 size) const {
+    if ((address & (CPU::PAGE_SIZE - 1)) != 0) {
+        return MemoryResult::InvalidAddress;
+    }
+    if (size == 0 || (size & (CPU::PAGE_SIZE - 1)) != 0) {
+        return MemoryResult::InvalidSize;
+    }
+    if (address >= address_space_size || size > address_space_size - address) {
+        return MemoryResult::InvalidAddress;
+    }
+    return MemoryResult::Success;
+}
+
+// Free ranges are always merged, so a free range lies within a single VMA.
+bool VMManager::is_free(u64 address, u64 size) const {
+    const VirtualMemoryArea& vma = find_vma(address)->second;
+    return vma.state == MemoryState::Free && vma.base + vma.size >= address + size;
+}
+
+bool VMManager::is_mapped(u64 address, u64 size) const {
+    for (auto it = find_vma(address); it != vmas.end() && it->first < address + size; ++it) {
+        if (it->second.state == MemoryState::Free) {
+            return false;
+        }
+    }
+    return true;
+}
+
+VMManager::VMAMap::iterator VMManager::find_vma(u64 address) {
+    return std::prev(vmas.upper_bound(address));
+}
+
+VMManager::VMAMap::const_iterator VMManager::find_vma(u64 address) const {
+    return std::prev(vmas.upper_bound(address));
+}
+
+// Splits the VMA at `offset` bytes from its base and returns the second half.
+VMManager::VMAMap::iterator VMManager::split_vma(VMAMap::iterator it, u64 offset) {
+    VirtualMemoryArea& first = it->second;
+    ASSERT(offset > 0 && offset < first.size);
+    VirtualMemoryArea second = first;
+    second.base += offset;
+    second.size -= offset;
+    if (second.state != MemoryState::Free) {
+        second.physical_base += offset;
+    }
+    first.size = offset;
+    return vmas.emplace_hint(std::next(it), second.base, second);
+}
+
+// Splits VMAs so that the range starts and ends on VMA boundaries, returns its first VMA.
+VMManager::VMAMap::iterator VMManager::carve_range(u64 address, u64 size) {
+    auto first = find_vma(address);
+    if (first->first != address) {
+        first = split_vma(first, address - first->first);
+    }
+    const u64 end = address + size;
+    auto last = find_vma(end - 1);
+    if (last->first + last->second.size != end) {
+        split_vma(last, end - last->first);
+    }
+    return first;
+}
+
+// Merges every VMA in or bordering the range with its compatible neighbours.
+void VMManager::coalesce(u64 address, u64 size) {
+    auto it = find_vma(address);
+    if (it != vmas.begin()) {
+        --it;
+    }
+    const u64 end = address + size;
+    while (it != vmas.end() && it->first <= end) {
+        const auto next = std::next(it);
+        if (next == vmas.end()) {
+            break;
+        }
+        if (it->second.can_merge_with(next->second)) {
+            it->second.size += next->second.size;
+            vmas.erase(next);
+        } else {
+            it = next;
+        }
+    }
+}
+
+}  // namespace Kernel
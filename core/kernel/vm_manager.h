@@ -0,0 +1,121 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#pragma once
+
+#include <map>
+
+#include "Base/Enum.h"
+#include "memory/physical_memory.h"
+
+namespace Kernel {
+
+enum class MemoryState : u32 {
+    Free,
+    Code,
+    CodeData,
+    Heap,
+    Shared,
+    Alias,
+    Stack,
+    Io,
+    // Reported by query() for addresses outside the address space
+    Inaccessible,
+};
+
+enum class MemoryPermission : u32 {
+    None = 0,
+    Read = 1 << 0,
+    Write = 1 << 1,
+    Execute = 1 << 2,
+    ReadWrite = Read | Write,
+    ReadExecute = Read | Execute,
+};
+DECLARE_ENUM_FLAG_OPERATORS(MemoryPermission)
+
+enum class MemoryResult {
+    Success,
+    InvalidAddress,
+    InvalidSize,
+    // The range is not in the state the operation requires (free for map, mapped otherwise)
+    InvalidCurrentMemory,
+    HostMappingFailed,
+};
+
+// A contiguous range of the guest address space with uniform state and permissions.
+struct VirtualMemoryArea {
+    u64 base = 0;
+    u64 size = 0;
+    MemoryState state = MemoryState::Free;
+    MemoryPermission permission = MemoryPermission::None;
+    // Offset of the backing memory in guest physical memory, unused while free
+    u64 physical_base = 0;
+
+    bool can_merge_with(const VirtualMemoryArea& next) const;
+};
+
+struct MemoryInfo {
+    u64 base = 0;
+    u64 size = 0;
+    MemoryState state = MemoryState::Free;
+    MemoryPermission permission = MemoryPermission::None;
+};
+
+// Tracks the layout of a guest address space and mirrors it into a fastmem view.
+//
+// The whole address space is covered by VMAs kept in a map ordered by base address, so finding
+// the VMA of an address is a single O(log n) lookup no matter how fragmented the space gets.
+// Every change splits the VMAs at the edges of the affected range and merges compatible
+// neighbours back afterwards, which keeps the map as small as the layout allows.
+//
+// Addresses and sizes are in bytes and must be multiples of CPU::PAGE_SIZE. With a view,
+// every mapped range is also mapped at the same offset of the view, so fastmem accesses see
+// exactly the guest layout; without one only the bookkeeping is done.
+class VMManager {
+public:
+    explicit VMManager(u64 address_space_size, const Memory::MemoryView* view = nullptr,
+                       const Memory::PhysicalMemory* physical = nullptr);
+
+    VMManager(const VMManager&) = delete;
+    VMManager& operator=(const VMManager&) = delete;
+
+    // Maps `size` bytes of physical memory at `physical_address` to the free range at `address`.
+    MemoryResult map(u64 address, u64 size, u64 physical_address, MemoryState state,
+                     MemoryPermission permission);
+
+    // Maps the physical memory currently backing [src, src + size) again at the free range
+    // `dst`, the source mapping is left untouched.
+    MemoryResult map_alias(u64 dst, u64 src, u64 size);
+
+    // Returns a range to the free state. Parts of it that are already free are left alone.
+    MemoryResult unmap(u64 address, u64 size);
+
+    // Changes the permissions of a range which must be entirely mapped.
+    MemoryResult protect(u64 address, u64 size, MemoryPermission permission);
+
+    // Describes the VMA containing `address`.
+    MemoryInfo query(u64 address) const;
+
+    size_t vma_count() const {
+        return vmas.size();
+    }
+
+private:
+    using VMAMap = std::map<u64, VirtualMemoryArea>;
+
+    MemoryResult check_range(u64 address, u64 size) const;
+    bool is_free(u64 address, u64 size) const;
+    bool is_mapped(u64 address, u64 size) const;
+
+    VMAMap::iterator find_vma(u64 address);
+    VMAMap::const_iterator find_vma(u64 address) const;
+    VMAMap::iterator split_vma(VMAMap::iterator it, u64 offset);
+    VMAMap::iterator carve_range(u64 address, u64 size);
+    void coalesce(u64 address, u64 size);
+
+    u64 address_space_size;
+    VMAMap vmas;
+    const Memory::MemoryView* view;
+    const Memory::PhysicalMemory* physical;
+};
+
+}  // namespace Kernel
@@ -3,11 +3,16 @@
 #include <thread>
 #include <memory>
 #include <chrono>
+#include <string_view>
 
 #include "Base/Logging/Backend.h"
 #include "Base/Config.h"
+#include "Base/Trace.h"
 #include "ARM/cpu.h"
 #include "JIT/jit.h"
+#include "kernel/replay.h"
+#include "kernel/scheduler.h"
+#include "memory/host_memory.h"
 
 #include "gui/GUIManager.h"
 #include "gui/panels/ConsolePanel.h"
@@ -30,7 +35,19 @@ void cpuTest()
     cpu.write_byte(8, 0xFF); // RET placeholder
     LOG_INFO(ARM, "{}", cpu.read_byte(0));
     JIT jit;
-    jit.translate_and_run(cpu);
+    // Runs as a guest thread so that scheduling decisions go through the replay log
+    std::thread guest([&cpu, &jit]
+                      {
+        Kernel::Scheduler scheduler(cpu);
+        const int numa_node = Config::numaNode();
+        if (numa_node >= 0)
+        {
+            scheduler.set_numa_node(numa_node);
+            jit.bind_to_numa_node(numa_node);
+        }
+        scheduler.create_thread([&cpu, &jit] { jit.translate_and_run(cpu); });
+        scheduler.run(); });
+    guest.join();
     cpu.print_debug_information();
     LOG_INFO(ARM, "X0 = {}", cpu.x(0));
 
@@ -53,6 +70,8 @@ void initGUI(Pound::GUI::GUIManager *gui_manager)
     gui_manager->AddSubTab(file_menu, "Exit", []()
                            {
         LOG_INFO(Render, "Exiting Pound Emulator");
+        Kernel::Replay::stop();
+        Base::Trace::Stop();
         std::exit(0); });
 
     gui_manager->AddSubTab(emulation_menu, "Run CPU Test", []()
@@ -66,17 +85,59 @@ void initGUI(Pound::GUI::GUIManager *gui_manager)
                            { LOG_INFO(Render, "Pound Emulator is a pre-alpha project. Visit our GitHub for more information."); });
 
     cpu_panel->SetCPUTestCallback(cpuTest);
-    console_panel->AddLog("[INFO] Pound Emulator started");
-    console_panel->AddLog("[INFO] Version: Pre-Alpha");
+    console_panel->AddLog("Pound Emulator started");
+    console_panel->AddLog("Version: Pre-Alpha");
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    // The log backends are picked from the config, so it is loaded first
+    const auto config_dir = Base::FS::GetUserPath(Base::FS::PathType::BinaryDir);
+    Config::Load(config_dir / "config.toml");
+
     Base::Log::Initialize();
     Base::Log::Start();
 
-    const auto config_dir = Base::FS::GetUserPath(Base::FS::PathType::BinaryDir);
-    Config::Load(config_dir / "config.toml");
+    const std::string huge_pages = Config::hugePages();
+    if (huge_pages == "transparent")
+        Memory::set_huge_page_mode(Memory::HUGE_PAGES_TRANSPARENT);
+    else if (huge_pages == "explicit")
+        Memory::set_huge_page_mode(Memory::HUGE_PAGES_EXPLICIT);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg != "--record" && arg != "--replay" && arg != "--trace")
+            continue;
+        if (i + 1 >= argc)
+        {
+            LOG_ERROR(System, "Missing file argument for {}", arg);
+            return -1;
+        }
+        const char *path = argv[++i];
+        bool started = false;
+        if (arg == "--record")
+            started = Kernel::Replay::start_recording(path);
+        else if (arg == "--replay")
+            started = Kernel::Replay::start_replay(path);
+        else
+            started = Base::Trace::Start(path);
+        if (!started)
+            return -1;
+    }
+
+    // Replays run headless so JIT changes can be benchmarked on identical workloads
+    if (Kernel::Replay::mode() == Kernel::Replay::Mode::Replay)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        cpuTest();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        LOG_INFO(System, "Replay finished in {} us",
+                 std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        Kernel::Replay::stop();
+        Base::Trace::Stop();
+        return 0;
+    }
 
     auto gui_manager = std::make_unique<Pound::GUI::GUIManager>();
     if (!gui_manager->Initialize("Pound Emulator", Config::windowWidth(), Config::windowHeight()))
@@ -98,6 +159,8 @@ int main()
         std::this_thread::sleep_for(std::chrono::milliseconds(5));
     }
     gui_manager->Shutdown();
+    Kernel::Replay::stop();
+    Base::Trace::Stop();
 
     return 0;
 }
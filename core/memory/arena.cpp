@@ -1,50 +1,215 @@
 #include "arena.h"
+#include "host_memory.h"
 #include "Base/Assert.h"
 #include "sys/mman.h"
 
-// Memory::Arena Memory::arena_init() {
-//     // TODO(GloriousTaco): The line below is stupidly unsafe. Replace malloc with mmap() and check the return value.
-//     auto data =
-//         static_cast<uint8_t*>(malloc(sizeof(uint8_t) * MEMORY_CAPACITY));
-//     Memory::Arena arena = {
-//         .capacity = MEMORY_CAPACITY,
-//         .size = 0,
-//         .data = data,
-//     };
-//     return arena;
-// }
-// old unsafe code
+#include <algorithm>
 
-Memory::Arena Memory::arena_init() {
-    void* data = mmap(nullptr, MEMORY_CAPACITY, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    if (data == MAP_FAILED) {
-        return {0, 0, nullptr}; // Return invalid arena on failure
+// Every block starts with its ArenaBlock header, padded to a cache line so allocations start aligned.
+static constexpr std::size_t BLOCK_HEADER_SIZE = 64;
+static_assert(sizeof(Memory::ArenaBlock) <= BLOCK_HEADER_SIZE);
+
+static std::size_t align_up(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static Memory::ArenaBlock* map_block(std::size_t reserved, Memory::ArenaMode mode,
+                                     bool huge_pages) {
+    reserved = align_up(reserved, ARENA_COMMIT_GRANULE);
+    void* base = nullptr;
+    std::size_t committed = 0;
+    if (mode == Memory::ARENA_MODE_RESERVE) {
+        base = mmap(nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+        committed = ARENA_COMMIT_GRANULE;
+        if (mprotect(base, committed, PROT_READ | PROT_WRITE) != 0) {
+            munmap(base, reserved);
+            return nullptr;
+        }
+    } else {
+        base = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+        committed = reserved;
+    }
+    if (huge_pages) {
+        Memory::host_advise_huge_pages(base, reserved);
+    }
+
+    Memory::ArenaBlock* block = static_cast<Memory::ArenaBlock*>(base);
+    block->prev = nullptr;
+    block->reserved = reserved;
+    block->committed = committed;
+    return block;
+}
+
+static void unmap_block(Memory::ArenaBlock* block) {
+    munmap(block, block->reserved);
+}
+
+static void use_block(Memory::Arena* arena, Memory::ArenaBlock* block) {
+    arena->block = block;
+    arena->data = reinterpret_cast<uint8_t*>(block) + BLOCK_HEADER_SIZE;
+    arena->capacity = block->reserved - BLOCK_HEADER_SIZE;
+    arena->size = 0;
+}
+
+// Reports everything consumed after `used` bytes as released.
+static void release_used(Memory::Arena* arena, std::size_t used) {
+    if (arena->stats != nullptr) {
+        Memory::alloc_stats_sub(arena->stats, arena->used - used);
+    }
+    arena->used = used;
+}
+
+// Makes sure the first `end` usable bytes of the current block are committed.
+static bool commit_block(Memory::Arena* arena, std::size_t end) {
+    Memory::ArenaBlock* block = arena->block;
+    const std::size_t needed = BLOCK_HEADER_SIZE + end;
+    if (needed <= block->committed) {
+        return true;
+    }
+    // Commit at least twice as much as before to keep the number of mprotect calls logarithmic.
+    const std::size_t target = std::min(
+        block->reserved, std::max(align_up(needed, ARENA_COMMIT_GRANULE), block->committed * 2));
+    uint8_t* const start = reinterpret_cast<uint8_t*>(block) + block->committed;
+    if (mprotect(start, target - block->committed, PROT_READ | PROT_WRITE) != 0) {
+        return false;
     }
+    block->committed = target;
+    return true;
+}
+
+Memory::Arena Memory::arena_init() {
+    return arena_create(ARENA_DEFAULT_RESERVE, ARENA_MODE_RESERVE);
+}
+
+Memory::Arena Memory::arena_create(std::size_t block_size, Memory::ArenaMode mode,
+                                   bool huge_pages) {
     Memory::Arena arena = {
-        .capacity = MEMORY_CAPACITY,
+        .capacity = 0,
         .size = 0,
-        .data = static_cast<uint8_t*>(data),
+        .data = nullptr,
+        .block = nullptr,
+        .mode = mode,
+        .used = 0,
+        .stats = nullptr,
+        .huge_pages = huge_pages,
     };
+    Memory::ArenaBlock* block = map_block(block_size + BLOCK_HEADER_SIZE, mode, huge_pages);
+    if (block == nullptr) {
+        return arena; // Return invalid arena on failure
+    }
+    use_block(&arena, block);
     return arena;
 }
-// new more memsafe code (ownedbywuigi) (i give up on windows compatibility for now, will stick to the old unsafe code)
 
 const uint8_t* Memory::arena_allocate(Memory::Arena* arena,
                                       const std::size_t size) {
+    return static_cast<const uint8_t*>(arena_allocate_aligned(arena, size, 1));
+}
+
+void* Memory::arena_allocate_aligned(Memory::Arena* arena, const std::size_t size,
+                                     const std::size_t alignment) {
     ASSERT(arena != nullptr);
-    ASSERT(arena->size + size < arena->capacity);
-    const uint8_t* const data = &(arena->data[arena->size]);
-    arena->size += size;
+    ASSERT(arena->block != nullptr);
+    ASSERT((alignment & (alignment - 1)) == 0);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(arena->data);
+    std::size_t offset = align_up(base + arena->size, alignment) - base;
+    if (offset > arena->capacity || size > arena->capacity - offset) {
+        // Chain a new block at least as large as the current one, the old block stays alive
+        // until the arena is reset.
+        const std::size_t reserve =
+            std::max(arena->block->reserved, size + alignment + BLOCK_HEADER_SIZE);
+        Memory::ArenaBlock* block = map_block(reserve, arena->mode, arena->huge_pages);
+        if (block == nullptr) {
+            LOG_ERROR(Memory, "Failed to map a {} byte arena block", reserve);
+            return nullptr;
+        }
+        block->prev = arena->block;
+        use_block(arena, block);
+        const uintptr_t new_base = reinterpret_cast<uintptr_t>(arena->data);
+        offset = align_up(new_base, alignment) - new_base;
+    }
+    if (!commit_block(arena, offset + size)) {
+        LOG_ERROR(Memory, "Failed to commit {} bytes of arena memory", offset + size);
+        return nullptr;
+    }
+    uint8_t* const data = &(arena->data[offset]);
+    const std::size_t consumed = offset + size - arena->size;
+    arena->size = offset + size;
+    arena->used += consumed;
+    if (arena->stats != nullptr) {
+        alloc_stats_add(arena->stats, consumed, 1);
+    }
     return data;
 }
+
 void Memory::arena_reset(Memory::Arena* arena) {
     ASSERT(arena != nullptr);
+    if (arena->block != nullptr) {
+        Memory::ArenaBlock* prev = arena->block->prev;
+        while (prev != nullptr) {
+            Memory::ArenaBlock* next = prev->prev;
+            unmap_block(prev);
+            prev = next;
+        }
+        arena->block->prev = nullptr;
+    }
+    release_used(arena, 0);
     arena->size = 0;
 }
+
+Memory::ArenaMarker Memory::arena_mark(const Memory::Arena* arena) {
+    ASSERT(arena != nullptr);
+    return {arena->block, arena->size, arena->used};
+}
+
+void Memory::arena_rewind(Memory::Arena* arena, Memory::ArenaMarker marker) {
+    ASSERT(arena != nullptr);
+    while (arena->block != marker.block) {
+        ASSERT_MSG(arena->block != nullptr, "Arena marker does not belong to this arena");
+        Memory::ArenaBlock* prev = arena->block->prev;
+        unmap_block(arena->block);
+        use_block(arena, prev);
+    }
+    release_used(arena, marker.used);
+    arena->size = marker.size;
+}
+
 void Memory::arena_free(Memory::Arena* arena) {
     ASSERT(arena != nullptr);
+    release_used(arena, 0);
+    Memory::ArenaBlock* block = arena->block;
+    while (block != nullptr) {
+        Memory::ArenaBlock* prev = block->prev;
+        unmap_block(block);
+        block = prev;
+    }
     arena->capacity = 0;
     arena->size = 0;
-    // TODO(GloriousTaco): Replace free with a memory safe alternative.
-    free(arena->data);
+    arena->data = nullptr;
+    arena->block = nullptr;
+}
+
+void* Memory::ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* data = arena_allocate_aligned(arena, bytes, alignment);
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    return data;
+}
+
+void Memory::ArenaResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    // Arena memory is only reclaimed by arena_reset() or arena_free().
+    (void)p;
+    (void)bytes;
+    (void)alignment;
+}
+
+bool Memory::ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
 }
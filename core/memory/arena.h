@@ -4,11 +4,60 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "stats.h"
 
 namespace Memory {
 
-/* Defines the default size (in bytes) for memory arenas created via arena_init() */
-#define MEMORY_CAPACITY 20480  // 20 KB
+/* Defines the default address space (in bytes) reserved by arena_init() */
+#define ARENA_DEFAULT_RESERVE (1ULL << 30)  // 1 GiB
+
+/* Defines the granularity (in bytes) at which reserved memory is committed */
+#define ARENA_COMMIT_GRANULE (64 * 1024)  // 64 KiB
+
+/* Defines the default block size (in bytes) of arenas in ARENA_MODE_CHAINED */
+#define ARENA_DEFAULT_CHUNK (256 * 1024)  // 256 KiB
+
+/*
+ *  NAME
+ *      ArenaMode - How an arena obtains memory from the host.
+ *
+ *  DESCRIPTION
+ *      ARENA_MODE_RESERVE reserves a large range of address space up front and
+ *      commits it page by page as the arena grows, so allocations stay contiguous
+ *      and untouched capacity costs no memory.
+ *
+ *      ARENA_MODE_CHAINED maps fully committed fixed-size chunks and links a new
+ *      one whenever the current chunk is full. Use it on hosts without overcommit,
+ *      where a large reservation would be charged in full.
+ *
+ *      In both modes an arena that outgrows its current block chains a new one,
+ *      so allocation never fails for lack of capacity.
+ */
+typedef enum {
+    ARENA_MODE_RESERVE,
+    ARENA_MODE_CHAINED,
+} ArenaMode;
+
+/*
+ *  NAME
+ *      ArenaBlock - Header placed at the start of every block mapped by an arena.
+ *
+ *  SYNOPSIS
+ *      typedef struct ArenaBlock {
+ *          struct ArenaBlock* prev;  The previously filled block, or nullptr.
+ *          std::size_t reserved;     Bytes of address space mapped for this block.
+ *          std::size_t committed;    Bytes of this block backed by memory.
+ *      } ArenaBlock;
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock* prev;
+    std::size_t reserved;
+    std::size_t committed;
+} ArenaBlock;
 
 /*
  *  NAME
@@ -16,14 +65,22 @@ namespace Memory {
  *
  *  SYNOPSIS
  *      typedef struct {
- *          std::size_t capacity;   Total number of bytes allocated.
- *          std::size_t size;       The current number of bytes consumed.
- *          uint8_t* data;          A pointer to the base address of the allocated memory buffer.
+ *          std::size_t capacity;   Usable bytes of the current block.
+ *          std::size_t size;       The number of bytes consumed in the current block.
+ *          uint8_t* data;          A pointer to the first usable byte of the current block.
+ *          ArenaBlock* block;      The current block, linked to the previously filled ones.
+ *          ArenaMode mode;         How new blocks are obtained.
+ *          std::size_t used;       Bytes consumed across all blocks, padding included.
+ *          AllocStats* stats;      Counters the arena reports to, or nullptr.
+ *          bool huge_pages;        Whether blocks ask for transparent huge pages.
  *      } Arena;
  *
  *  DESCRIPTION
  *      The arena struct handles allocating and managing contiguous memory blocks.
  *
+ *      Setting stats (for example to alloc_stats_get("jit")) makes the arena report
+ *      its allocations, and the memory released by resets, to the performance panel.
+ *
  *  RATIONALE
  *      A memory arena offers a safer alternative to malloc/realloc by
  *      maintaining a single contiguous block eliminates heap fragmentation
@@ -33,6 +90,11 @@ typedef struct {
     std::size_t capacity;
     std::size_t size;
     uint8_t* data;
+    ArenaBlock* block;
+    ArenaMode mode;
+    std::size_t used;
+    AllocStats* stats;
+    bool huge_pages;
 } Arena;
 
 /*
@@ -43,15 +105,40 @@ typedef struct {
  *      Arena Memory::arena_init();
  *
  *  DESCRIPTION
- *     The function creates and returns a new memory arena instance with a
- *     pre-allocated capacity. See the definition MEMORY_CAPACITY to change the
- *     default capacity.
+ *     The function creates and returns a new memory arena reserving
+ *     ARENA_DEFAULT_RESERVE bytes of address space in ARENA_MODE_RESERVE.
+ *     Equivalent to arena_create(ARENA_DEFAULT_RESERVE, ARENA_MODE_RESERVE).
  *
  *  RETURN VALUE
- *     Returns a valid Arena object on success.
+ *     Returns a valid Arena object on success. On failure the returned arena has
+ *     a null data pointer.
  */
 extern Arena arena_init();
 
+/*
+ *  NAME
+ *      arena_create - Initialize a memory arena with an explicit size and mode.
+ *
+ *  SYNOPSIS
+ *      Arena Memory::arena_create(std::size_t block_size, Memory::ArenaMode mode,
+ *                                 bool huge_pages = false);
+ *
+ *  DESCRIPTION
+ *      In ARENA_MODE_RESERVE, block_size is the amount of address space reserved
+ *      for the first block; only ARENA_COMMIT_GRANULE bytes of it are committed
+ *      until allocations need more. In ARENA_MODE_CHAINED, block_size is the size
+ *      of each fully committed chunk.
+ *
+ *      If huge_pages is true and the huge page mode (see host_memory.h) is not
+ *      HUGE_PAGES_OFF, every block is advised to use transparent huge pages. Only
+ *      worth it for large, long-lived arenas: a huge page is committed as a whole.
+ *
+ *  RETURN VALUE
+ *     Returns a valid Arena object on success. On failure the returned arena has
+ *     a null data pointer.
+ */
+Arena arena_create(std::size_t block_size, ArenaMode mode, bool huge_pages = false);
+
 /*
  *  NAME
  *      arena_allocate - Allocate memory from a pre-initialized arena.
@@ -60,19 +147,39 @@ extern Arena arena_init();
  *      const uint8_t Memory::arena_allocate(Memory::Arena* arena, std::size_t size);
  *
  *  DESCRIPTION
- *      The function allocates size bytes from the specified arena. It assumes
- *      the arena has sufficient capacity and returns a pointer to the allocated
- *      memory region.
+ *      The function allocates size bytes from the specified arena. When the current
+ *      block is exhausted, more of its reservation is committed, or a new block
+ *      large enough for the request is chained to the arena.
  *
  *  RETURN VALUE
  *      Returns a pointer to the first byte of the allocated memory. The returned
- *      pointer is valid until the arena is reset or destroyed.
+ *      pointer is valid until the arena is reset or destroyed. Returns nullptr if
+ *      the host is out of memory.
  *
  *  NOTES
  *      Requires Arena to be initialized with arena_init() or similar.
  */
 const uint8_t* arena_allocate(Arena* arena, std::size_t size);
 
+/*
+ *  NAME
+ *      arena_allocate_aligned - Allocate aligned memory from a pre-initialized arena.
+ *
+ *  SYNOPSIS
+ *      void* Memory::arena_allocate_aligned(Memory::Arena* arena, std::size_t size,
+ *                                           std::size_t alignment);
+ *
+ *  DESCRIPTION
+ *      Same as arena_allocate(), but the returned address is a multiple of
+ *      alignment, which must be a power of two. The padding needed to reach it
+ *      is consumed from the arena.
+ *
+ *  RETURN VALUE
+ *      Returns a pointer to the first byte of the allocated memory, or nullptr if
+ *      the host is out of memory.
+ */
+void* arena_allocate_aligned(Arena* arena, std::size_t size, std::size_t alignment);
+
 /*
  *  NAME
  *      arena_reset - Reset a memory arena's allocation size to zero.
@@ -82,17 +189,41 @@ const uint8_t* arena_allocate(Arena* arena, std::size_t size);
  *
  *  DESCRIPTION
  *      The function resets the allocation size of a pre-initialized Arena to zero.
- *      This effectively "frees" all memory allocated from the arena without
- *      deallocating the underlying buffer, allowing reuse of the capacity for
- *      future allocations.
+ *      This effectively "frees" all memory allocated from the arena, allowing reuse
+ *      of the capacity for future allocations.
  *
  *  NOTES
- *      Resets arena->size to 0 while preserving arena->capacity.
- *      Does not free the underlying memory buffer.
- *      Useful for reusing arenas without reallocation.
+ *      Releases every chained block except the current (largest and most recent)
+ *      one, whose committed memory is kept for reuse.
  */
 void arena_reset(Arena* arena);
 
+/*
+ *  NAME
+ *      arena_mark, arena_rewind - Release everything allocated after a point.
+ *
+ *  SYNOPSIS
+ *      Memory::ArenaMarker Memory::arena_mark(const Memory::Arena* arena);
+ *      void Memory::arena_rewind(Memory::Arena* arena, Memory::ArenaMarker marker);
+ *
+ *  DESCRIPTION
+ *      arena_mark() records the current allocation position. arena_rewind()
+ *      returns the arena to that position, unmapping any block chained since.
+ *      Allocations made before the mark stay valid, which makes nested
+ *      temporary scopes on a shared arena possible.
+ *
+ *  NOTES
+ *      Markers must be rewound in LIFO order and are invalidated by arena_reset().
+ */
+typedef struct {
+    ArenaBlock* block;
+    std::size_t size;
+    std::size_t used;
+} ArenaMarker;
+
+ArenaMarker arena_mark(const Arena* arena);
+void arena_rewind(Arena* arena, ArenaMarker marker);
+
 /**
  *  NAME
  *      arena_free - Free the memory allocated by an arena
@@ -101,11 +232,83 @@ void arena_reset(Arena* arena);
  *      void Memory::arena_free(Memory::Arena* arena);
  *
  *  DESCRIPTION
- *      The function releases the memory buffer associated with a Arena and
- *      resets its capacity and size to zero. This marks the arena as invalid for
- *      future allocation unless reinitialized.
+ *      The function unmaps every block associated with a Arena and resets its
+ *      capacity and size to zero. This marks the arena as invalid for future
+ *      allocation unless reinitialized.
  */
 void arena_free(Memory::Arena* arena);
 
+/*
+ *  NAME
+ *      arena_new, arena_new_array - Construct objects in place inside an arena.
+ *
+ *  SYNOPSIS
+ *      T* Memory::arena_new<T>(Memory::Arena* arena, Args&&... args);
+ *      T* Memory::arena_new_array<T>(Memory::Arena* arena, std::size_t count);
+ *
+ *  DESCRIPTION
+ *      arena_new() allocates correctly aligned storage for a T and constructs it
+ *      with args. arena_new_array() does the same for count value-initialized
+ *      elements.
+ *
+ *  RETURN VALUE
+ *      Returns the constructed object, or nullptr if the allocation failed.
+ *
+ *  NOTES
+ *      Resetting or freeing the arena does not run destructors. Objects owning
+ *      other resources must be destroyed by hand before the arena is reset.
+ */
+template <typename T, typename... Args>
+T* arena_new(Arena* arena, Args&&... args) {
+    void* memory = arena_allocate_aligned(arena, sizeof(T), alignof(T));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    return new (memory) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+T* arena_new_array(Arena* arena, std::size_t count) {
+    void* memory = arena_allocate_aligned(arena, sizeof(T) * count, alignof(T));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    return new (memory) T[count]();
+}
+
+/*
+ *  NAME
+ *      ArenaResource - std::pmr::memory_resource allocating from a Memory::Arena.
+ *
+ *  SYNOPSIS
+ *      Memory::ArenaResource resource(&arena);
+ *      std::pmr::vector<int> values(&resource);
+ *
+ *  DESCRIPTION
+ *      Lets std::pmr containers draw their storage from an arena. Deallocation is
+ *      a no-op; the memory is reclaimed all at once by arena_reset() or
+ *      arena_free(), so containers using the resource must not outlive the next
+ *      reset.
+ *
+ *  NOTES
+ *      Throws std::bad_alloc if the arena cannot satisfy a request, as required
+ *      by the memory_resource contract.
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(Arena* arena) : arena(arena) {}
+
+    Arena* get_arena() const {
+        return arena;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    Arena* arena;
+};
+
 }  // namespace Memory
 #endif  //POUND_ARENA_H
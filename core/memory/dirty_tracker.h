@@ -0,0 +1,99 @@
+#ifndef POUND_DIRTY_TRACKER_H
+#define POUND_DIRTY_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Memory {
+
+/*
+ *  NAME
+ *      DirtyPageTracker - Records which guest pages were written in which epoch.
+ *
+ *  SYNOPSIS
+ *      Memory::DirtyPageTracker tracker(page_count, page_bits);
+ *      uint32_t epoch = tracker.advance_epoch();
+ *      ...guest runs...
+ *      tracker.for_each_written_since(epoch, [](std::size_t page) { ... });
+ *
+ *  DESCRIPTION
+ *      Every page owns a 32-bit stamp holding the epoch in which it was last written.
+ *      Marking a write is a single store of the current epoch, cheap enough for the
+ *      interpreter write path and simple enough to emit inline from the JIT: the
+ *      generated code stores epoch_value() to stamps()[address >> page_bits].
+ *
+ *      A consumer (texture cache, incremental savestate, SMC detection, ...) calls
+ *      advance_epoch() when it has synchronized with guest memory and remembers the
+ *      returned value. Pages written afterwards carry a newer stamp and are reported by
+ *      written_since(). Any number of consumers can hold different epochs at once.
+ *
+ *  NOTES
+ *      Stamps are not atomic. A write racing with a query is reported by the next query.
+ *      The epoch counter wraps after 2^32 advances, which is not a practical concern.
+ */
+class DirtyPageTracker {
+public:
+    DirtyPageTracker(std::size_t page_count, std::size_t page_bits)
+        : page_bits(page_bits), page_stamps(page_count, 0) {}
+
+    void mark(uint64_t addr) {
+        page_stamps[addr >> page_bits] = epoch.load(std::memory_order_relaxed);
+    }
+
+    void mark_range(uint64_t addr, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        const uint32_t current = epoch.load(std::memory_order_relaxed);
+        const std::size_t last = (addr + size - 1) >> page_bits;
+        for (std::size_t page = addr >> page_bits; page <= last; ++page) {
+            page_stamps[page] = current;
+        }
+    }
+
+    /*
+     * Closes the current epoch and returns it. Pages written from now on report as
+     * written_since() the returned value.
+     */
+    uint32_t advance_epoch() {
+        return epoch.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool written_since(std::size_t page, uint32_t since) const {
+        return page_stamps[page] > since;
+    }
+
+    template <typename Func>
+    void for_each_written_since(uint32_t since, Func&& func) const {
+        for (std::size_t page = 0; page < page_stamps.size(); ++page) {
+            if (page_stamps[page] > since) {
+                func(page);
+            }
+        }
+    }
+
+    std::vector<std::size_t> pages_written_since(uint32_t since) const {
+        std::vector<std::size_t> pages;
+        for_each_written_since(since, [&pages](std::size_t page) { pages.push_back(page); });
+        return pages;
+    }
+
+    // Raw state for JIT emitted marking.
+    uint32_t* stamps() {
+        return page_stamps.data();
+    }
+    const std::atomic<uint32_t>* epoch_value() const {
+        return &epoch;
+    }
+
+private:
+    std::size_t page_bits;
+    // Starts at 1 so that untouched pages (stamp 0) are never reported.
+    std::atomic<uint32_t> epoch{1};
+    std::vector<uint32_t> page_stamps;
+};
+
+}  // namespace Memory
+#endif  //POUND_DIRTY_TRACKER_H
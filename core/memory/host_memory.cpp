@@ -0,0 +1,149 @@
+#include "host_memory.h"
+#include "Base/Logging/Log.h"
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include "sys/mman.h"
+#endif
+
+static std::atomic<Memory::HugePageMode> current_mode{Memory::HUGE_PAGES_OFF};
+
+static std::size_t align_up(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Huge pages are only implemented on Linux, everything else maps base pages.
+static bool uses_huge_pages(bool huge_pages) {
+#if defined(__linux__)
+    return huge_pages && current_mode.load(std::memory_order_relaxed) != Memory::HUGE_PAGES_OFF;
+#else
+    (void)huge_pages;
+    return false;
+#endif
+}
+
+void Memory::set_huge_page_mode(Memory::HugePageMode mode) {
+    current_mode.store(mode, std::memory_order_relaxed);
+}
+
+Memory::HugePageMode Memory::huge_page_mode() {
+    return current_mode.load(std::memory_order_relaxed);
+}
+
+#if defined(_WIN32)
+
+int Memory::host_native_protection(int prot) {
+    if (prot & HOST_PROT_EXEC) {
+        return (prot & HOST_PROT_WRITE) ? PAGE_EXECUTE_READWRITE : PAGE_EXECUTE_READ;
+    }
+    if (prot & HOST_PROT_WRITE) {
+        return PAGE_READWRITE;
+    }
+    if (prot & HOST_PROT_READ) {
+        return PAGE_READONLY;
+    }
+    return PAGE_NOACCESS;
+}
+
+void* Memory::host_map(std::size_t size, int prot, bool huge_pages) {
+    (void)huge_pages;  // Large pages need SeLockMemoryPrivilege, which users rarely grant
+    return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, host_native_protection(prot));
+}
+
+void Memory::host_unmap(void* address, std::size_t size, bool huge_pages) {
+    (void)size;
+    (void)huge_pages;
+    VirtualFree(address, 0, MEM_RELEASE);
+}
+
+void Memory::host_advise_huge_pages(void* address, std::size_t size) {
+    (void)address;
+    (void)size;
+}
+
+#else
+
+int Memory::host_native_protection(int prot) {
+    int native = PROT_NONE;
+    if (prot & HOST_PROT_READ) {
+        native |= PROT_READ;
+    }
+    if (prot & HOST_PROT_WRITE) {
+        native |= PROT_WRITE;
+    }
+    if (prot & HOST_PROT_EXEC) {
+        native |= PROT_EXEC;
+    }
+    return native;
+}
+
+void* Memory::host_map(std::size_t size, int prot, bool huge_pages) {
+    const int native = host_native_protection(prot);
+    if (!uses_huge_pages(huge_pages)) {
+        void* address = mmap(nullptr, size, native, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return address != MAP_FAILED ? address : nullptr;
+    }
+
+    size = align_up(size, HUGE_PAGE_SIZE);
+#if defined(MAP_HUGETLB)
+    if (huge_page_mode() == HUGE_PAGES_EXPLICIT) {
+        void* address =
+            mmap(nullptr, size, native, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (address != MAP_FAILED) {
+            return address;
+        }
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true)) {
+            LOG_WARNING(Memory, "No huge pages left in the hugetlbfs pool, falling back to "
+                                "transparent huge pages");
+        }
+    }
+#endif
+
+    // Transparent huge pages are only used for 2 MiB aligned ranges, so over-map and trim.
+    uint8_t* raw = static_cast<uint8_t*>(
+        mmap(nullptr, size + HUGE_PAGE_SIZE, native, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    uint8_t* aligned = reinterpret_cast<uint8_t*>(
+        align_up(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+    if (aligned != raw) {
+        munmap(raw, aligned - raw);
+    }
+    const std::size_t tail = (raw + size + HUGE_PAGE_SIZE) - (aligned + size);
+    if (tail != 0) {
+        munmap(aligned + size, tail);
+    }
+    host_advise_huge_pages(aligned, size);
+    return aligned;
+}
+
+void Memory::host_unmap(void* address, std::size_t size, bool huge_pages) {
+    if (address == nullptr) {
+        return;
+    }
+    if (uses_huge_pages(huge_pages)) {
+        size = align_up(size, HUGE_PAGE_SIZE);
+    }
+    munmap(address, size);
+}
+
+void Memory::host_advise_huge_pages(void* address, std::size_t size) {
+#if defined(MADV_HUGEPAGE)
+    if (huge_page_mode() == HUGE_PAGES_OFF) {
+        return;
+    }
+    // Fails harmlessly on kernels built without transparent huge pages
+    madvise(address, size, MADV_HUGEPAGE);
+#else
+    (void)address;
+    (void)size;
+#endif
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef POUND_HOST_MEMORY_H
+#define POUND_HOST_MEMORY_H
+
+#include <cstddef>
+
+namespace Memory {
+
+/* Defines the size (in bytes) of the huge pages requested from the host */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)  // 2 MiB
+
+/* Protection flags accepted by host_map(), combinable with | */
+#define HOST_PROT_READ 0x1
+#define HOST_PROT_WRITE 0x2
+#define HOST_PROT_EXEC 0x4
+
+/*
+ *  NAME
+ *      HugePageMode - Whether large host mappings are backed by huge pages.
+ *
+ *  DESCRIPTION
+ *      HUGE_PAGES_OFF maps everything with the host's base page size.
+ *
+ *      HUGE_PAGES_TRANSPARENT aligns large mappings to HUGE_PAGE_SIZE and asks the
+ *      kernel to back them with transparent huge pages (madvise(MADV_HUGEPAGE)).
+ *      Needs no configuration on the host, but the kernel is free to ignore it.
+ *
+ *      HUGE_PAGES_EXPLICIT maps from the hugetlbfs pool (MAP_HUGETLB). The pool
+ *      must be reserved beforehand (vm.nr_hugepages); when it is empty the mapping
+ *      falls back to HUGE_PAGES_TRANSPARENT.
+ *
+ *      Guest working sets of several GiB thrash the TLB with 4 KiB pages, so guest
+ *      memory and the JIT code cache benefit most.
+ *
+ *  NOTES
+ *      Huge pages are only requested on Linux. Other hosts always use base pages.
+ */
+typedef enum {
+    HUGE_PAGES_OFF,
+    HUGE_PAGES_TRANSPARENT,
+    HUGE_PAGES_EXPLICIT,
+} HugePageMode;
+
+/*
+ *  NAME
+ *      set_huge_page_mode, huge_page_mode - Select how huge pages are used.
+ *
+ *  SYNOPSIS
+ *      void Memory::set_huge_page_mode(Memory::HugePageMode mode);
+ *      Memory::HugePageMode Memory::huge_page_mode();
+ *
+ *  DESCRIPTION
+ *      The mode only affects mappings made after it is set, so it should be set
+ *      once at startup, right after the configuration is loaded.
+ */
+void set_huge_page_mode(HugePageMode mode);
+HugePageMode huge_page_mode();
+
+/*
+ *  NAME
+ *      host_map, host_unmap - Map committed memory directly from the host.
+ *
+ *  SYNOPSIS
+ *      void* Memory::host_map(std::size_t size, int prot, bool huge_pages);
+ *      void Memory::host_unmap(void* address, std::size_t size, bool huge_pages);
+ *
+ *  DESCRIPTION
+ *      host_map() maps size bytes of zeroed, private memory with the HOST_PROT_*
+ *      protection prot. If huge_pages is true the mapping follows the current
+ *      HugePageMode, and its size is rounded up to HUGE_PAGE_SIZE when huge pages
+ *      are in use.
+ *
+ *      host_unmap() must be called with the same size and huge_pages values that
+ *      were passed to host_map().
+ *
+ *  RETURN VALUE
+ *      host_map() returns the address of the mapping, or nullptr on failure.
+ */
+void* host_map(std::size_t size, int prot, bool huge_pages);
+void host_unmap(void* address, std::size_t size, bool huge_pages);
+
+/*
+ *  NAME
+ *      host_native_protection - Translate HOST_PROT_* flags for the host.
+ *
+ *  SYNOPSIS
+ *      int Memory::host_native_protection(int prot);
+ *
+ *  RETURN VALUE
+ *      Returns the matching PROT_* combination on POSIX hosts, or the PAGE_*
+ *      constant on Windows.
+ */
+int host_native_protection(int prot);
+
+/*
+ *  NAME
+ *      host_advise_huge_pages - Ask for transparent huge pages over a range.
+ *
+ *  SYNOPSIS
+ *      void Memory::host_advise_huge_pages(void* address, std::size_t size);
+ *
+ *  DESCRIPTION
+ *      For mappings not made by host_map(), such as reserved arena blocks. Does
+ *      nothing when the mode is HUGE_PAGES_OFF or the host has no huge pages.
+ */
+void host_advise_huge_pages(void* address, std::size_t size);
+
+}  // namespace Memory
+#endif  //POUND_HOST_MEMORY_H
@@ -0,0 +1,219 @@
+#include "physical_memory.h"
+#include "host_memory.h"
+#include "Base/Assert.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include "sys/mman.h"
+#endif
+
+#if defined(__APPLE__)
+#include <atomic>
+#endif
+
+#if defined(_WIN32)
+
+Memory::PhysicalMemory Memory::physical_memory_create(std::size_t size) {
+    Memory::PhysicalMemory memory = {
+        .size = 0,
+        .linear = nullptr,
+        .fd = -1,
+        .handle = nullptr,
+    };
+    const uint64_t size64 = size;
+    HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(size64 >> 32),
+                                       static_cast<DWORD>(size64), nullptr);
+    if (handle == nullptr) {
+        LOG_ERROR(Memory, "Failed to create {} bytes of guest physical memory", size);
+        return memory;
+    }
+    void* linear = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (linear == nullptr) {
+        LOG_ERROR(Memory, "Failed to map the linear view of guest physical memory");
+        CloseHandle(handle);
+        return memory;
+    }
+    memory.size = size;
+    memory.linear = static_cast<uint8_t*>(linear);
+    memory.handle = handle;
+    return memory;
+}
+
+void Memory::physical_memory_destroy(Memory::PhysicalMemory* memory) {
+    ASSERT(memory != nullptr);
+    if (memory->linear != nullptr) {
+        UnmapViewOfFile(memory->linear);
+    }
+    if (memory->handle != nullptr) {
+        CloseHandle(memory->handle);
+    }
+    memory->size = 0;
+    memory->linear = nullptr;
+    memory->handle = nullptr;
+}
+
+Memory::MemoryView Memory::view_reserve(std::size_t size) {
+    void* base = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+    if (base == nullptr) {
+        return {nullptr, 0};
+    }
+    return {static_cast<uint8_t*>(base), size};
+}
+
+void Memory::view_release(Memory::MemoryView* view) {
+    ASSERT(view != nullptr);
+    if (view->base != nullptr) {
+        VirtualFree(view->base, 0, MEM_RELEASE);
+    }
+    view->base = nullptr;
+    view->size = 0;
+}
+
+// Mapping a file view into part of a reservation needs VirtualAlloc2/MapViewOfFile3
+// placeholders, which are not wired up yet.
+bool Memory::view_map(const Memory::MemoryView* view, uint64_t offset,
+                      const Memory::PhysicalMemory* memory, uint64_t physical_offset,
+                      std::size_t size, int prot) {
+    (void)view;
+    (void)offset;
+    (void)memory;
+    (void)physical_offset;
+    (void)size;
+    (void)prot;
+    return false;
+}
+
+bool Memory::view_unmap(const Memory::MemoryView* view, uint64_t offset, std::size_t size) {
+    (void)view;
+    (void)offset;
+    (void)size;
+    return false;
+}
+
+bool Memory::view_protect(const Memory::MemoryView* view, uint64_t offset, std::size_t size,
+                          int prot) {
+    (void)view;
+    (void)offset;
+    (void)size;
+    (void)prot;
+    return false;
+}
+
+#else
+
+static bool view_contains(const Memory::MemoryView* view, uint64_t offset, std::size_t size) {
+    return view->base != nullptr && offset <= view->size && size <= view->size - offset;
+}
+
+static int create_shared_memory() {
+#if defined(__linux__)
+    return memfd_create("pound-guest-ram", MFD_CLOEXEC);
+#else
+    // No memfd, use an anonymous POSIX shared memory object that is unlinked right away
+    static std::atomic<unsigned> counter{0};
+    const std::string name = fmt::format("/pound-{}-{}", getpid(), counter++);
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name.c_str());
+    }
+    return fd;
+#endif
+}
+
+// Explicit hugetlbfs pages are not used here even in HUGE_PAGES_EXPLICIT mode: they would force
+// every view mapping to 2 MiB granularity, and guest aliases are 4 KiB.
+Memory::PhysicalMemory Memory::physical_memory_create(std::size_t size) {
+    Memory::PhysicalMemory memory = {
+        .size = 0,
+        .linear = nullptr,
+        .fd = -1,
+        .handle = nullptr,
+    };
+    const int fd = create_shared_memory();
+    if (fd < 0) {
+        LOG_ERROR(Memory, "Failed to create the guest physical memory object");
+        return memory;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_ERROR(Memory, "Failed to size guest physical memory to {} bytes", size);
+        close(fd);
+        return memory;
+    }
+    void* linear = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (linear == MAP_FAILED) {
+        LOG_ERROR(Memory, "Failed to map the linear view of guest physical memory");
+        close(fd);
+        return memory;
+    }
+    host_advise_huge_pages(linear, size);
+    memory.size = size;
+    memory.linear = static_cast<uint8_t*>(linear);
+    memory.fd = fd;
+    return memory;
+}
+
+void Memory::physical_memory_destroy(Memory::PhysicalMemory* memory) {
+    ASSERT(memory != nullptr);
+    if (memory->linear != nullptr) {
+        munmap(memory->linear, memory->size);
+    }
+    if (memory->fd >= 0) {
+        close(memory->fd);
+    }
+    memory->size = 0;
+    memory->linear = nullptr;
+    memory->fd = -1;
+}
+
+Memory::MemoryView Memory::view_reserve(std::size_t size) {
+    void* base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return {nullptr, 0};
+    }
+    return {static_cast<uint8_t*>(base), size};
+}
+
+void Memory::view_release(Memory::MemoryView* view) {
+    ASSERT(view != nullptr);
+    if (view->base != nullptr) {
+        munmap(view->base, view->size);
+    }
+    view->base = nullptr;
+    view->size = 0;
+}
+
+bool Memory::view_map(const Memory::MemoryView* view, uint64_t offset,
+                      const Memory::PhysicalMemory* memory, uint64_t physical_offset,
+                      std::size_t size, int prot) {
+    ASSERT(view_contains(view, offset, size));
+    ASSERT(physical_offset <= memory->size && size <= memory->size - physical_offset);
+    void* address = mmap(view->base + offset, size, host_native_protection(prot),
+                         MAP_SHARED | MAP_FIXED, memory->fd, static_cast<off_t>(physical_offset));
+    if (address == MAP_FAILED) {
+        LOG_ERROR(Memory, "Failed to map {:#x} bytes of physical memory at {:#x} into view {}",
+                  size, physical_offset, fmt::ptr(view->base));
+        return false;
+    }
+    host_advise_huge_pages(address, size);
+    return true;
+}
+
+bool Memory::view_unmap(const Memory::MemoryView* view, uint64_t offset, std::size_t size) {
+    ASSERT(view_contains(view, offset, size));
+    // Map an inaccessible placeholder over the range so it stays reserved
+    void* address = mmap(view->base + offset, size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    return address != MAP_FAILED;
+}
+
+bool Memory::view_protect(const Memory::MemoryView* view, uint64_t offset, std::size_t size,
+                          int prot) {
+    ASSERT(view_contains(view, offset, size));
+    return mprotect(view->base + offset, size, host_native_protection(prot)) == 0;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef POUND_PHYSICAL_MEMORY_H
+#define POUND_PHYSICAL_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Memory {
+
+/*
+ *  NAME
+ *      PhysicalMemory - Guest physical RAM backed by a single shared memory object.
+ *
+ *  SYNOPSIS
+ *      typedef struct {
+ *          std::size_t size;   Bytes of guest physical memory.
+ *          uint8_t* linear;    Linear view, physical address N lives at linear[N].
+ *          int fd;             memfd (shm object on macOS), -1 on Windows.
+ *          void* handle;       File mapping handle on Windows, nullptr elsewhere.
+ *      } PhysicalMemory;
+ *
+ *  DESCRIPTION
+ *      Every physical page exists once, in the shared memory object, and can be
+ *      mapped into any number of MemoryViews. The linear view is what DMA and the
+ *      GPU use to reach guest buffers; the fastmem guest address space is another
+ *      view, and a physical page mapped at several guest addresses (aliases,
+ *      shared memory) is simply mapped several times. Writes through one view are
+ *      immediately visible in all the others, with no copies.
+ *
+ *  NOTES
+ *      Views are mapped with host page granularity. On hosts with 16 KiB pages
+ *      (Apple Silicon) guest 4 KiB pages can't be aliased individually.
+ */
+typedef struct {
+    std::size_t size;
+    uint8_t* linear;
+    int fd;
+    void* handle;
+} PhysicalMemory;
+
+/*
+ *  NAME
+ *      physical_memory_create - Allocate guest physical memory.
+ *
+ *  SYNOPSIS
+ *      Memory::PhysicalMemory Memory::physical_memory_create(std::size_t size);
+ *
+ *  DESCRIPTION
+ *      Creates a zero filled shared memory object of size bytes and maps its
+ *      linear view. Unless the huge page mode (see host_memory.h) is
+ *      HUGE_PAGES_OFF the linear view is advised to use transparent huge
+ *      pages. hugetlbfs is not used even in HUGE_PAGES_EXPLICIT mode, since
+ *      it would force 2 MiB granularity on every view of the object.
+ *
+ *  RETURN VALUE
+ *      On failure the returned object has a null linear pointer.
+ */
+PhysicalMemory physical_memory_create(std::size_t size);
+
+/*
+ *  NAME
+ *      physical_memory_destroy - Release guest physical memory.
+ *
+ *  SYNOPSIS
+ *      void Memory::physical_memory_destroy(Memory::PhysicalMemory* memory);
+ *
+ *  NOTES
+ *      Views still mapping the memory stay valid until they are unmapped; the host
+ *      frees the pages once the last mapping goes away.
+ */
+void physical_memory_destroy(PhysicalMemory* memory);
+
+/*
+ *  NAME
+ *      MemoryView - A reserved host address range physical memory is mapped into.
+ *
+ *  SYNOPSIS
+ *      typedef struct {
+ *          uint8_t* base;      First byte of the reservation.
+ *          std::size_t size;   Bytes reserved.
+ *      } MemoryView;
+ *
+ *  DESCRIPTION
+ *      Unmapped parts of a view are inaccessible, so a fastmem access to an
+ *      unmapped guest address faults instead of touching unrelated host memory.
+ */
+typedef struct {
+    uint8_t* base;
+    std::size_t size;
+} MemoryView;
+
+/*
+ *  NAME
+ *      view_reserve, view_release - Reserve and release a view.
+ *
+ *  SYNOPSIS
+ *      Memory::MemoryView Memory::view_reserve(std::size_t size);
+ *      void Memory::view_release(Memory::MemoryView* view);
+ *
+ *  RETURN VALUE
+ *      On failure view_reserve() returns a view with a null base.
+ */
+MemoryView view_reserve(std::size_t size);
+void view_release(MemoryView* view);
+
+/*
+ *  NAME
+ *      view_map, view_unmap, view_protect - Manage the mappings of a view.
+ *
+ *  SYNOPSIS
+ *      bool Memory::view_map(const Memory::MemoryView* view, uint64_t offset,
+ *                            const Memory::PhysicalMemory* memory,
+ *                            uint64_t physical_offset, std::size_t size, int prot);
+ *      bool Memory::view_unmap(const Memory::MemoryView* view, uint64_t offset,
+ *                              std::size_t size);
+ *      bool Memory::view_protect(const Memory::MemoryView* view, uint64_t offset,
+ *                                std::size_t size, int prot);
+ *
+ *  DESCRIPTION
+ *      view_map() maps size bytes of physical memory starting at physical_offset
+ *      at view->base + offset, replacing whatever was mapped there. prot is a
+ *      combination of the HOST_PROT_* flags from host_memory.h.
+ *
+ *      view_unmap() makes the range inaccessible again, keeping it reserved.
+ *      view_protect() changes the protection of a mapped range.
+ *
+ *      Offsets and sizes must be multiples of the host page size.
+ *
+ *  RETURN VALUE
+ *      Returns true on success, false if the host refused the change.
+ *
+ *  NOTES
+ *      Not supported on Windows yet, where placeholder mappings need
+ *      VirtualAlloc2/MapViewOfFile3. There view_map() always fails and guest memory
+ *      is accessed through the linear view only.
+ */
+bool view_map(const MemoryView* view, uint64_t offset, const PhysicalMemory* memory,
+              uint64_t physical_offset, std::size_t size, int prot);
+bool view_unmap(const MemoryView* view, uint64_t offset, std::size_t size);
+bool view_protect(const MemoryView* view, uint64_t offset, std::size_t size, int prot);
+
+}  // namespace Memory
+#endif  //POUND_PHYSICAL_MEMORY_H
@@ -0,0 +1,39 @@
+#include "scratch.h"
+#include "Base/Assert.h"
+
+namespace {
+
+struct ScratchArena {
+    Memory::Arena arena;
+    Memory::ArenaResource resource;
+
+    ScratchArena()
+        : arena(Memory::arena_create(SCRATCH_ARENA_RESERVE, Memory::ARENA_MODE_RESERVE)),
+          resource(&arena) {
+        ASSERT_MSG(arena.data != nullptr, "Failed to reserve the scratch arena");
+        arena.stats = Memory::alloc_stats_get("scratch");
+    }
+
+    ~ScratchArena() {
+        Memory::arena_free(&arena);
+    }
+};
+
+ScratchArena& get_scratch() {
+    static thread_local ScratchArena scratch;
+    return scratch;
+}
+
+}  // namespace
+
+Memory::Arena* Memory::scratch_arena() {
+    return &get_scratch().arena;
+}
+
+std::pmr::memory_resource* Memory::scratch_resource() {
+    return &get_scratch().resource;
+}
+
+void Memory::scratch_reset() {
+    Memory::arena_reset(&get_scratch().arena);
+}
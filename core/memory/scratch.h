@@ -0,0 +1,64 @@
+#ifndef POUND_SCRATCH_H
+#define POUND_SCRATCH_H
+
+#include <memory_resource>
+
+#include "arena.h"
+
+namespace Memory {
+
+/* Defines the address space (in bytes) reserved for each thread's scratch arena */
+#define SCRATCH_ARENA_RESERVE (256ULL << 20)  // 256 MiB
+
+/*
+ *  NAME
+ *      scratch_arena - Get the calling thread's scratch arena.
+ *
+ *  SYNOPSIS
+ *      Memory::Arena* Memory::scratch_arena();
+ *
+ *  DESCRIPTION
+ *      Every thread owns a scratch arena, created on first use and freed when the
+ *      thread exits. It holds temporaries whose lifetime ends at the thread's next
+ *      reset point; the GUI thread resets at the start of every frame. Allocating
+ *      from it never takes a lock, so threads don't contend on the global heap.
+ *
+ *  RETURN VALUE
+ *      Returns the arena of the calling thread. Never nullptr.
+ */
+Arena* scratch_arena();
+
+/*
+ *  NAME
+ *      scratch_resource - Get a std::pmr::memory_resource over the scratch arena.
+ *
+ *  SYNOPSIS
+ *      std::pmr::memory_resource* Memory::scratch_resource();
+ *
+ *  DESCRIPTION
+ *      Lets temporary containers draw from the calling thread's scratch arena:
+ *
+ *          std::pmr::vector<int> values(Memory::scratch_resource());
+ *          std::pmr::string text(Memory::scratch_resource());
+ *
+ *  NOTES
+ *      Containers using the resource must be destroyed before the next
+ *      scratch_reset() on the same thread, and must not be handed to another thread.
+ */
+std::pmr::memory_resource* scratch_resource();
+
+/*
+ *  NAME
+ *      scratch_reset - Release everything allocated from the scratch arena.
+ *
+ *  SYNOPSIS
+ *      void Memory::scratch_reset();
+ *
+ *  DESCRIPTION
+ *      Resets the calling thread's scratch arena. Only call it at points where no
+ *      scratch allocation made by this thread is still in use.
+ */
+void scratch_reset();
+
+}  // namespace Memory
+#endif  //POUND_SCRATCH_H
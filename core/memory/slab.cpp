@@ -0,0 +1,276 @@
+#include "slab.h"
+#include "arena.h"
+#include "stats.h"
+#include "Base/Assert.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace {
+
+struct FreeNode {
+    FreeNode* next;
+};
+
+struct SlabCache {
+    Memory::SlabClass* slab_class = nullptr;
+    // Only touched by the owning thread
+    FreeNode* free_list = nullptr;
+    // Objects freed by other threads, reclaimed in one exchange
+    std::atomic<FreeNode*> remote_free{nullptr};
+    // Number of objects in remote_free pushes not yet reported to the class stats
+    std::atomic<uint64_t> remote_freed{0};
+    // Next cache of the same class, for adoption after the owner exits
+    SlabCache* next_cache = nullptr;
+    bool owned = true;
+    // Allocations and local frees not yet reported to the class stats
+    uint64_t pending_allocations = 0;
+    uint64_t pending_frees = 0;
+};
+
+// Stored at the start of every slab page, found from an object by masking its address.
+struct PageHeader {
+    SlabCache* owner;
+};
+
+// Remote frees waiting to be handed to their owner in one go.
+struct RemoteBatch {
+    SlabCache* owner = nullptr;
+    FreeNode* head = nullptr;
+    FreeNode* tail = nullptr;
+    std::size_t count = 0;
+};
+
+constexpr std::size_t REMOTE_BATCH_SIZE = 64;
+// Number of owner operations after which a cache reports its counts to the class stats
+constexpr uint64_t STATS_BATCH_SIZE = 64;
+
+std::size_t align_up(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+struct Memory::SlabClass {
+    std::size_t index;
+    std::size_t object_size;
+    std::size_t first_offset;
+    // Caches of every thread that ever used this class, guarded by registry_mutex
+    SlabCache* caches;
+    Memory::AllocStats* stats;
+    char name[32];
+};
+
+namespace {
+
+std::mutex registry_mutex;
+std::array<Memory::SlabClass, SLAB_MAX_CLASSES> classes;
+std::size_t class_count = 0;
+Memory::Arena page_arena = {};
+
+// Allocations are reported before frees so live_bytes never dips below zero.
+void flush_stats(SlabCache* cache) {
+    const Memory::SlabClass* slab_class = cache->slab_class;
+    const uint64_t frees =
+        cache->pending_frees + cache->remote_freed.exchange(0, std::memory_order_relaxed);
+    Memory::alloc_stats_add(slab_class->stats, cache->pending_allocations * slab_class->object_size,
+                            cache->pending_allocations);
+    Memory::alloc_stats_sub(slab_class->stats, frees * slab_class->object_size);
+    cache->pending_allocations = 0;
+    cache->pending_frees = 0;
+}
+
+void flush_batch(RemoteBatch& batch) {
+    if (batch.head == nullptr) {
+        return;
+    }
+    batch.owner->remote_freed.fetch_add(batch.count, std::memory_order_relaxed);
+    std::atomic<FreeNode*>& list = batch.owner->remote_free;
+    FreeNode* expected = list.load(std::memory_order_relaxed);
+    do {
+        batch.tail->next = expected;
+    } while (!list.compare_exchange_weak(expected, batch.head, std::memory_order_release,
+                                         std::memory_order_relaxed));
+    batch = {};
+}
+
+void release_cache(SlabCache* cache) {
+    flush_stats(cache);
+    cache->owned = false;
+}
+
+// Set once the thread's caches are released. Trivially destructible, so it stays valid for
+// slab calls from thread_local destructors that run after ~ThreadCaches.
+thread_local bool caches_released = false;
+
+struct ThreadCaches {
+    std::array<SlabCache*, SLAB_MAX_CLASSES> caches{};
+    RemoteBatch batch;
+
+    ~ThreadCaches() {
+        flush_batch(batch);
+        std::scoped_lock lock{registry_mutex};
+        for (SlabCache*& cache : caches) {
+            if (cache != nullptr) {
+                release_cache(cache);
+                // Another thread may adopt it from now on, so it must never be used from here
+                cache = nullptr;
+            }
+        }
+        caches_released = true;
+    }
+};
+
+thread_local ThreadCaches thread_caches;
+
+SlabCache* acquire_cache(Memory::SlabClass* slab_class) {
+    std::scoped_lock lock{registry_mutex};
+    // Adopt a cache left behind by an exited thread before creating a new one
+    for (SlabCache* cache = slab_class->caches; cache != nullptr; cache = cache->next_cache) {
+        if (!cache->owned) {
+            cache->owned = true;
+            return cache;
+        }
+    }
+    SlabCache* cache = new SlabCache();
+    cache->slab_class = slab_class;
+    cache->next_cache = slab_class->caches;
+    slab_class->caches = cache;
+    return cache;
+}
+
+bool refill(SlabCache* cache) {
+    uint8_t* page = nullptr;
+    {
+        std::scoped_lock lock{registry_mutex};
+        if (page_arena.block == nullptr) {
+            page_arena = Memory::arena_create(ARENA_DEFAULT_RESERVE, Memory::ARENA_MODE_RESERVE, true);
+            page_arena.stats = Memory::alloc_stats_get("slab pages");
+        }
+        page = static_cast<uint8_t*>(
+            Memory::arena_allocate_aligned(&page_arena, SLAB_PAGE_SIZE, SLAB_PAGE_SIZE));
+    }
+    if (page == nullptr) {
+        return false;
+    }
+    reinterpret_cast<PageHeader*>(page)->owner = cache;
+
+    const Memory::SlabClass* slab_class = cache->slab_class;
+    const std::size_t count = (SLAB_PAGE_SIZE - slab_class->first_offset) / slab_class->object_size;
+    // Link back to front so objects are handed out in address order
+    FreeNode* head = cache->free_list;
+    for (std::size_t i = count; i-- > 0;) {
+        FreeNode* node = reinterpret_cast<FreeNode*>(page + slab_class->first_offset +
+                                                     i * slab_class->object_size);
+        node->next = head;
+        head = node;
+    }
+    cache->free_list = head;
+    return true;
+}
+
+void* pop_object(SlabCache* cache) {
+    if (cache->free_list == nullptr) [[unlikely]] {
+        cache->free_list = cache->remote_free.exchange(nullptr, std::memory_order_acquire);
+        if (cache->free_list == nullptr && !refill(cache)) {
+            LOG_ERROR(Memory, "Failed to allocate a slab page");
+            return nullptr;
+        }
+    }
+    FreeNode* node = cache->free_list;
+    cache->free_list = node->next;
+    if (++cache->pending_allocations + cache->pending_frees >= STATS_BATCH_SIZE) {
+        flush_stats(cache);
+    }
+    return node;
+}
+
+// After teardown a thread borrows a cache for every allocation and hands it straight back.
+void* allocate_released(Memory::SlabClass* slab_class) {
+    SlabCache* cache = acquire_cache(slab_class);
+    void* object = pop_object(cache);
+    std::scoped_lock lock{registry_mutex};
+    release_cache(cache);
+    return object;
+}
+
+}  // namespace
+
+Memory::SlabClass* Memory::slab_class_get(std::size_t size, std::size_t alignment) {
+    ASSERT((alignment & (alignment - 1)) == 0 && alignment <= 4096);
+    alignment = std::max<std::size_t>(alignment, 16);
+    const std::size_t object_size = align_up(std::max(size, sizeof(FreeNode)), alignment);
+    const std::size_t first_offset = align_up(sizeof(PageHeader), alignment);
+    ASSERT_MSG(first_offset + object_size <= SLAB_PAGE_SIZE, "Object too large for a slab");
+
+    std::scoped_lock lock{registry_mutex};
+    for (std::size_t i = 0; i < class_count; ++i) {
+        if (classes[i].object_size == object_size && classes[i].first_offset == first_offset) {
+            return &classes[i];
+        }
+    }
+    ASSERT_MSG(class_count < SLAB_MAX_CLASSES, "Out of slab size classes");
+    SlabClass& slab_class = classes[class_count];
+    slab_class = {class_count, object_size, first_offset, nullptr, nullptr, {}};
+    fmt::format_to_n(slab_class.name, sizeof(slab_class.name) - 1, "slab {}", object_size);
+    slab_class.stats = alloc_stats_get(slab_class.name);
+    ++class_count;
+    return &slab_class;
+}
+
+void* Memory::slab_allocate(Memory::SlabClass* slab_class) {
+    SlabCache*& cache = thread_caches.caches[slab_class->index];
+    if (cache == nullptr) [[unlikely]] {
+        if (caches_released) {
+            return allocate_released(slab_class);
+        }
+        cache = acquire_cache(slab_class);
+    }
+    return pop_object(cache);
+}
+
+void Memory::slab_free(void* object) {
+    if (object == nullptr) {
+        return;
+    }
+    const uintptr_t page = reinterpret_cast<uintptr_t>(object) & ~uintptr_t{SLAB_PAGE_SIZE - 1};
+    SlabCache* owner = reinterpret_cast<PageHeader*>(page)->owner;
+    FreeNode* node = static_cast<FreeNode*>(object);
+
+    if (thread_caches.caches[owner->slab_class->index] == owner) [[likely]] {
+        node->next = owner->free_list;
+        owner->free_list = node;
+        if (owner->pending_allocations + ++owner->pending_frees >= STATS_BATCH_SIZE) {
+            flush_stats(owner);
+        }
+        return;
+    }
+
+    if (caches_released) [[unlikely]] {
+        // Nothing would flush a batch any more, hand the object over on its own
+        RemoteBatch single{owner, node, node, 1};
+        node->next = nullptr;
+        flush_batch(single);
+        return;
+    }
+
+    RemoteBatch& batch = thread_caches.batch;
+    if (batch.owner != owner || batch.count == REMOTE_BATCH_SIZE) {
+        flush_batch(batch);
+        batch.owner = owner;
+    }
+    node->next = batch.head;
+    batch.head = node;
+    if (batch.tail == nullptr) {
+        batch.tail = node;
+    }
+    ++batch.count;
+}
+
+void Memory::slab_flush_remote() {
+    if (!caches_released) {
+        flush_batch(thread_caches.batch);
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef POUND_SLAB_H
+#define POUND_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Memory {
+
+/* Defines the size (and alignment) in bytes of the pages slabs are carved from */
+#define SLAB_PAGE_SIZE (64 * 1024)  // 64 KiB
+
+/* Defines the maximum number of distinct size classes */
+#define SLAB_MAX_CLASSES 64
+
+/*
+ *  NAME
+ *      SlabClass - A pool of fixed-size objects.
+ *
+ *  DESCRIPTION
+ *      Objects of one size class are carved out of SLAB_PAGE_SIZE aligned pages.
+ *      Every thread owns a private cache per class holding a free list, so the
+ *      allocation and same-thread free paths are a pointer pop/push without any
+ *      atomic operation or lock.
+ *
+ *      An object freed by a thread other than the one that carved it is queued in
+ *      a thread-local batch, and the batch is pushed onto the owner's lock-free
+ *      remote free list with a single compare-and-swap. The owner reclaims its
+ *      whole remote list with one exchange when its local free list runs dry.
+ *
+ *      When a thread exits, its caches are released and adopted by the next thread
+ *      that needs one, together with any objects still sitting in them. Slab
+ *      calls made later on that thread, from other thread_local destructors,
+ *      borrow a cache per allocation and treat every free as remote.
+ *
+ *  NOTES
+ *      Pages are never returned to the host; slab classes are meant for hot,
+ *      long-lived object types whose population only churns.
+ */
+typedef struct SlabClass SlabClass;
+
+/*
+ *  NAME
+ *      slab_class_get - Get the size class serving objects of a given size.
+ *
+ *  SYNOPSIS
+ *      Memory::SlabClass* Memory::slab_class_get(std::size_t size, std::size_t alignment);
+ *
+ *  DESCRIPTION
+ *      Sizes are rounded up to a multiple of 16 (or of alignment, if larger), and
+ *      every request rounding to the same size shares one class and free list.
+ *      alignment must be a power of two no larger than 4096.
+ */
+SlabClass* slab_class_get(std::size_t size, std::size_t alignment);
+
+/*
+ *  NAME
+ *      slab_allocate, slab_free - Allocate and free a slab object.
+ *
+ *  SYNOPSIS
+ *      void* Memory::slab_allocate(Memory::SlabClass* slab_class);
+ *      void Memory::slab_free(void* object);
+ *
+ *  DESCRIPTION
+ *      slab_allocate() returns uninitialized storage for one object of the class,
+ *      or nullptr if the host is out of memory. slab_free() returns an object to
+ *      the class it came from and may be called from any thread.
+ */
+void* slab_allocate(SlabClass* slab_class);
+void slab_free(void* object);
+
+/*
+ *  NAME
+ *      slab_flush_remote - Hand pending remote frees to their owners.
+ *
+ *  SYNOPSIS
+ *      void Memory::slab_flush_remote();
+ *
+ *  DESCRIPTION
+ *      Objects the calling thread freed on behalf of other threads are only
+ *      pushed to their owner once a batch fills up or the thread frees into a
+ *      different owner. Threads call this at points where they go idle, such as
+ *      the start of a frame, so a partial batch doesn't keep objects away from
+ *      their owner. Threads flush on exit by themselves.
+ */
+void slab_flush_remote();
+
+/*
+ *  NAME
+ *      slab_new, slab_delete - Construct and destroy objects from a slab.
+ *
+ *  SYNOPSIS
+ *      T* Memory::slab_new<T>(Args&&... args);
+ *      void Memory::slab_delete<T>(T* object);
+ */
+template <typename T, typename... Args>
+T* slab_new(Args&&... args) {
+    static SlabClass* const slab_class = slab_class_get(sizeof(T), alignof(T));
+    void* memory = slab_allocate(slab_class);
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    return new (memory) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void slab_delete(T* object) {
+    if (object == nullptr) {
+        return;
+    }
+    object->~T();
+    slab_free(object);
+}
+
+/*
+ *  NAME
+ *      SlabPtr - A std::unique_ptr owning an object from slab_new().
+ */
+struct SlabDeleter {
+    template <typename T>
+    void operator()(T* object) const {
+        slab_delete(object);
+    }
+};
+
+template <typename T>
+using SlabPtr = std::unique_ptr<T, SlabDeleter>;
+
+}  // namespace Memory
+#endif  //POUND_SLAB_H
@@ -0,0 +1,160 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string_view>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::mutex registry_mutex;
+Memory::AllocStats* registry_head = nullptr;
+Memory::AllocStats* registry_tail = nullptr;
+
+std::atomic<uint64_t> heap_allocations{0};
+std::atomic<uint64_t> heap_bytes{0};
+thread_local Memory::HeapCounters thread_heap = {};
+
+}  // namespace
+
+Memory::AllocStats* Memory::alloc_stats_get(const char* name) {
+    std::scoped_lock lock{registry_mutex};
+    for (Memory::AllocStats* stats = registry_head; stats != nullptr; stats = stats->next) {
+        if (std::string_view{stats->name} == name) {
+            return stats;
+        }
+    }
+    Memory::AllocStats* stats = new Memory::AllocStats();
+    stats->name = name;
+    if (registry_tail != nullptr) {
+        registry_tail->next = stats;
+    } else {
+        registry_head = stats;
+    }
+    registry_tail = stats;
+    return stats;
+}
+
+std::pmr::vector<Memory::AllocStatsSnapshot> Memory::alloc_stats_snapshot(
+    std::pmr::memory_resource* resource) {
+    std::pmr::vector<Memory::AllocStatsSnapshot> snapshot(resource);
+    std::scoped_lock lock{registry_mutex};
+    for (const Memory::AllocStats* stats = registry_head; stats != nullptr; stats = stats->next) {
+        snapshot.push_back({
+            .name = stats->name,
+            .live_bytes = stats->live_bytes.load(std::memory_order_relaxed),
+            .peak_bytes = stats->peak_bytes.load(std::memory_order_relaxed),
+            .total_bytes = stats->total_bytes.load(std::memory_order_relaxed),
+            .allocations = stats->allocations.load(std::memory_order_relaxed),
+        });
+    }
+    return snapshot;
+}
+
+Memory::HeapCounters Memory::heap_counters() {
+    return {heap_allocations.load(std::memory_order_relaxed),
+            heap_bytes.load(std::memory_order_relaxed)};
+}
+
+Memory::HeapCounters Memory::heap_thread_counters() {
+    return thread_heap;
+}
+
+std::size_t Memory::process_resident_bytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info = {};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#else
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return 0;
+    }
+    unsigned long total_pages = 0;
+    unsigned long resident_pages = 0;
+    const int fields = std::fscanf(statm, "%lu %lu", &total_pages, &resident_pages);
+    std::fclose(statm);
+    if (fields != 2) {
+        return 0;
+    }
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+#ifdef POUND_COUNT_ALLOCATIONS
+
+// Replacements of the global allocation functions. The nothrow and array forms provided by the
+// standard library forward to these, so every heap allocation is counted exactly once.
+
+static void count_allocation(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    thread_heap.allocations++;
+    thread_heap.bytes += size;
+}
+
+void* operator new(std::size_t size) {
+    count_allocation(size);
+    if (void* p = std::malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    count_allocation(size);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    void* p = _aligned_malloc(size != 0 ? size : 1, align);
+#else
+    // aligned_alloc() wants the size to be a multiple of the alignment
+    void* p = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) & ~(align - 1));
+#endif
+    if (p != nullptr) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(p, alignment);
+}
+
+#endif  // POUND_COUNT_ALLOCATIONS
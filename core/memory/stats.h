@@ -0,0 +1,150 @@
+#ifndef POUND_STATS_H
+#define POUND_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Memory {
+
+/*
+ *  NAME
+ *      AllocStats - Allocation counters of one named allocator.
+ *
+ *  SYNOPSIS
+ *      typedef struct AllocStats {
+ *          const char* name;                   Name shown in the performance panel.
+ *          std::atomic<uint64_t> live_bytes;   Bytes currently handed out.
+ *          std::atomic<uint64_t> peak_bytes;   High-water mark of live_bytes.
+ *          std::atomic<uint64_t> total_bytes;  Bytes handed out since startup.
+ *          std::atomic<uint64_t> allocations;  Allocations since startup.
+ *          struct AllocStats* next;            Next registered allocator.
+ *      } AllocStats;
+ *
+ *  DESCRIPTION
+ *      Several allocators may share one AllocStats (every thread's scratch arena
+ *      reports as "scratch", for instance). The counters are updated with relaxed
+ *      atomics, so readers on other threads see consistent but slightly stale
+ *      values. Allocation rates are derived by the reader from total_bytes.
+ *
+ *  NOTES
+ *      AllocStats objects are never unregistered and must have static storage
+ *      duration.
+ */
+typedef struct AllocStats {
+    const char* name;
+    std::atomic<uint64_t> live_bytes;
+    std::atomic<uint64_t> peak_bytes;
+    std::atomic<uint64_t> total_bytes;
+    std::atomic<uint64_t> allocations;
+    struct AllocStats* next;
+} AllocStats;
+
+/*
+ *  NAME
+ *      alloc_stats_get - Get the counters registered under a name.
+ *
+ *  SYNOPSIS
+ *      Memory::AllocStats* Memory::alloc_stats_get(const char* name);
+ *
+ *  DESCRIPTION
+ *      Returns the counters registered under name, registering new ones on first
+ *      use. name must be a string literal or otherwise outlive the process.
+ */
+AllocStats* alloc_stats_get(const char* name);
+
+/*
+ *  NAME
+ *      alloc_stats_add, alloc_stats_sub - Record allocations and releases.
+ *
+ *  SYNOPSIS
+ *      void Memory::alloc_stats_add(Memory::AllocStats* stats, uint64_t bytes,
+ *                                   uint64_t count);
+ *      void Memory::alloc_stats_sub(Memory::AllocStats* stats, uint64_t bytes);
+ *
+ *  DESCRIPTION
+ *      alloc_stats_add() records count allocations totalling bytes and raises the
+ *      high-water mark if needed. alloc_stats_sub() records bytes being released.
+ *      Allocators on hot paths should batch their updates.
+ */
+inline void alloc_stats_add(AllocStats* stats, uint64_t bytes, uint64_t count) {
+    const uint64_t live = stats->live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    stats->total_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    stats->allocations.fetch_add(count, std::memory_order_relaxed);
+    uint64_t peak = stats->peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !stats->peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+inline void alloc_stats_sub(AllocStats* stats, uint64_t bytes) {
+    stats->live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+/*
+ *  NAME
+ *      AllocStatsSnapshot, alloc_stats_snapshot - Read every registered allocator.
+ *
+ *  SYNOPSIS
+ *      std::pmr::vector<Memory::AllocStatsSnapshot> Memory::alloc_stats_snapshot(
+ *          std::pmr::memory_resource* resource);
+ *
+ *  DESCRIPTION
+ *      Returns a copy of the counters of every registered allocator in
+ *      registration order, allocated from resource. Names point to the
+ *      registered names, which live as long as the process, so periodic readers
+ *      can keep the copy on a scratch arena.
+ */
+typedef struct {
+    const char* name;
+    uint64_t live_bytes;
+    uint64_t peak_bytes;
+    uint64_t total_bytes;
+    uint64_t allocations;
+} AllocStatsSnapshot;
+
+std::pmr::vector<AllocStatsSnapshot> alloc_stats_snapshot(
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/*
+ *  NAME
+ *      HeapCounters, heap_counters, heap_thread_counters - Global heap usage.
+ *
+ *  SYNOPSIS
+ *      Memory::HeapCounters Memory::heap_counters();
+ *      Memory::HeapCounters Memory::heap_thread_counters();
+ *
+ *  DESCRIPTION
+ *      When built with POUND_COUNT_ALLOCATIONS, the global operator new is replaced
+ *      to count every heap allocation and the bytes requested. heap_counters()
+ *      returns the totals of the whole process, heap_thread_counters() those of
+ *      the calling thread. Per-frame figures are the difference between two calls.
+ *
+ *      Without POUND_COUNT_ALLOCATIONS both return zeroes and the global heap is
+ *      left untouched.
+ */
+typedef struct {
+    uint64_t allocations;
+    uint64_t bytes;
+} HeapCounters;
+
+HeapCounters heap_counters();
+HeapCounters heap_thread_counters();
+
+/*
+ *  NAME
+ *      process_resident_bytes - Get the resident set size of the process.
+ *
+ *  SYNOPSIS
+ *      std::size_t Memory::process_resident_bytes();
+ *
+ *  RETURN VALUE
+ *      Returns the number of bytes of physical memory currently used by the
+ *      process, or 0 if the host does not report it.
+ */
+std::size_t process_resident_bytes();
+
+}  // namespace Memory
+#endif  //POUND_STATS_H
@@ -5,28 +5,37 @@
 
 #if defined(__linux__) || defined(__APPLE__)
 // Linux or macOS: Use standard sys/mman.h
-#include <sys/mman.h>
+// core/ is on the include path, so a plain <sys/mman.h> would find this file again.
+#include_next <sys/mman.h>
 
 #else
-// Windows: Define mmap, munmap, and MAP_FAILED
+// Windows: Define mmap, munmap, mprotect and MAP_FAILED
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
 #define MAP_FAILED ((void*)-1)
 
 // Protection and flag constants (minimal subset for your use case)
+#define PROT_NONE  0x0
 #define PROT_READ  0x1
 #define PROT_WRITE 0x2
 #define MAP_PRIVATE 0x2
 #define MAP_ANONYMOUS 0x20
+#define MAP_NORESERVE 0x4000
 
 // mmap equivalent using VirtualAlloc
+// PROT_NONE only reserves address space, it can be committed later with mprotect().
 inline void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
     (void)addr;   // Ignored (VirtualAlloc doesn't support specific address)
     (void)flags;  // Ignored (simplified for anonymous mapping)
     (void)fd;     // Ignored (no file mapping)
     (void)offset; // Ignored (no file mapping)
 
+    if (prot == PROT_NONE) {
+        void* ptr = VirtualAlloc(nullptr, length, MEM_RESERVE, PAGE_NOACCESS);
+        return ptr ? ptr : MAP_FAILED;
+    }
+
     DWORD protect = 0;
     if (prot & PROT_READ && prot & PROT_WRITE) {
         protect = PAGE_READWRITE;
@@ -40,6 +49,16 @@ inline void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t
     return ptr ? ptr : MAP_FAILED;
 }
 
+// mprotect equivalent, commits reserved pages when they become accessible
+inline int mprotect(void* addr, size_t length, int prot) {
+    if (prot == PROT_NONE) {
+        DWORD old_protect = 0;
+        return VirtualProtect(addr, length, PAGE_NOACCESS, &old_protect) ? 0 : -1;
+    }
+    const DWORD protect = (prot & PROT_WRITE) ? PAGE_READWRITE : PAGE_READONLY;
+    return VirtualAlloc(addr, length, MEM_COMMIT, protect) ? 0 : -1;
+}
+
 // munmap equivalent using VirtualFree
 inline int munmap(void* addr, size_t length) {
     (void)length; // Ignored (VirtualFree doesn't need length for committed memory)
@@ -49,4 +68,4 @@ inline int munmap(void* addr, size_t length) {
 
 #endif
 
-#endif // MMAN_H
\ No newline at end of file
+#endif // MMAN_H
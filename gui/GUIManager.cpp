@@ -3,6 +3,9 @@
 #include "GUIManager.h"
 #include "Colors.h"
 #include "Base/Logging/Log.h"
+#include "Base/Trace.h"
+#include "memory/scratch.h"
+#include "memory/slab.h"
 #include <imgui.h>
 #include <imgui_impl_sdl3.h>
 #include <imgui_impl_opengl3.h>
@@ -93,17 +96,23 @@ namespace Pound::GUI
         if (!running)
             return;
 
+        SCOPED_TRACE("GUI::RunFrame");
+
+        // Nothing allocated from the GUI thread's scratch arena outlives a frame
+        Memory::scratch_reset();
+        // Slab objects freed here for other threads go back to them at least once a frame
+        Memory::slab_flush_remote();
+
         window->ProcessEvents();
 
         BeginFrame();
         RenderTabBars();
 
+        // Hidden panels are rendered too, they check their own visibility and some keep
+        // working while hidden (the console drains the log viewer ring)
         for (auto &panel : panels)
         {
-            if (panel->IsVisible())
-            {
-                panel->Render();
-            }
+            panel->Render();
         }
 
         if (show_demo_window)
@@ -123,6 +132,7 @@ namespace Pound::GUI
 
     void GUIManager::EndFrame()
     {
+        SCOPED_TRACE("GUI::EndFrame");
         ImGui::Render();
 
         ImGuiIO &io = ImGui::GetIO();
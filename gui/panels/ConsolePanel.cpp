@@ -2,22 +2,28 @@
 
 #include "ConsolePanel.h"
 #include "../Colors.h"
-#include <chrono>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
+#include "Base/Logging/Filter.h"
+#include "Base/Trace.h"
 
 namespace Pound::GUI
 {
 
-    ConsolePanel::ConsolePanel() : Panel("Console") {}
+    ConsolePanel::ConsolePanel() : Panel("Console")
+    {
+        class_enabled.fill(true);
+        // Start receiving log entries from the log thread
+        Base::Log::SetViewerEnabled(true);
+    }
 
     void ConsolePanel::Render()
     {
+        // Drain even while hidden, so the viewer ring doesn't overflow
+        DrainLogs();
+
         if (!visible) {
             return;
         }
-        
+
         if (!ImGui::Begin(name.c_str(), &visible))
         {
             ImGui::End();
@@ -36,24 +42,45 @@ namespace Pound::GUI
         if (ImGui::Button("Options"))
             ImGui::OpenPopup("Options");
         ImGui::SameLine();
+        if (ImGui::Button("Filter"))
+            ImGui::OpenPopup("Filter");
+        RenderFilters();
+        ImGui::SameLine();
         if (ImGui::Button("Clear"))
             Clear();
         ImGui::SameLine();
-        ImGui::Text("Log entries: %zu", log_buffer.size());
+        ImGui::Text("Log entries: %zu / %llu", filtered_lines.size(),
+                    static_cast<unsigned long long>(next_line - first_line));
+        RenderDroppedMessages();
 
         ImGui::Separator();
 
-        // Log display
+        // Log display, only the visible rows are submitted
         ImGui::BeginChild("ScrollingRegion", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
 
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
 
-        for (const auto &entry : log_buffer)
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(filtered_lines.size()));
+        while (clipper.Step())
         {
-            ImGui::PushStyleColor(ImGuiCol_Text, entry.color);
-            ImGui::TextUnformatted(entry.text.c_str());
-            ImGui::PopStyleColor();
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+            {
+                const LogEntry &entry = log_buffer[filtered_lines[i] % MAX_LOG_ENTRIES];
+                if (show_timestamps)
+                {
+                    ImGui::TextDisabled("[%10.4f] ", entry.timestamp.count() / 1000000.0);
+                    ImGui::SameLine();
+                }
+                ImGui::PushStyleColor(ImGuiCol_Text, GetLogColor(entry.level));
+                ImGui::Text("[%s] <%s> ", Base::Log::GetLogClassName(entry.log_class),
+                            Base::Log::GetLevelName(entry.level));
+                ImGui::SameLine();
+                ImGui::TextUnformatted(entry.text.data(), entry.text.data() + entry.text.size());
+                ImGui::PopStyleColor();
+            }
         }
+        clipper.End();
 
         if (auto_scroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
             ImGui::SetScrollHereY(1.0f);
@@ -64,51 +91,183 @@ namespace Pound::GUI
         ImGui::End();
     }
 
-    void ConsolePanel::AddLog(const std::string &text)
+    void ConsolePanel::RenderFilters()
     {
-        std::string final_text = text;
+        using namespace Base::Log;
+
+        if (!ImGui::BeginPopup("Filter"))
+        {
+            return;
+        }
+
+        bool changed = false;
+        const char *level_name = GetLevelName(static_cast<Level>(min_level));
+        if (ImGui::BeginCombo("Minimum level", level_name))
+        {
+            for (int level = 0; level < static_cast<int>(Level::Count); level++)
+            {
+                if (ImGui::Selectable(GetLevelName(static_cast<Level>(level)), level == min_level))
+                {
+                    min_level = level;
+                    changed = true;
+                }
+            }
+            ImGui::EndCombo();
+        }
 
-        if (show_timestamps)
+        ImGui::Separator();
+        if (ImGui::Button("All"))
+        {
+            class_enabled.fill(true);
+            changed = true;
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("None"))
         {
-            auto now = std::chrono::system_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(now);
-            std::stringstream ss;
-            ss << "[" << std::put_time(std::localtime(&time_t), "%H:%M:%S") << "] ";
-            final_text = ss.str() + text;
+            class_enabled.fill(false);
+            changed = true;
+        }
+        for (size_t i = 0; i < class_enabled.size(); i++)
+        {
+            changed |= ImGui::Checkbox(GetLogClassName(static_cast<Class>(i)), &class_enabled[i]);
         }
 
-        log_buffer.push_back({final_text, GetLogColor(text)});
+        ImGui::EndPopup();
 
-        // Keep buffer size limited
-        while (log_buffer.size() > MAX_LOG_ENTRIES)
+        if (changed)
         {
-            log_buffer.pop_front();
+            RebuildFilter();
         }
     }
 
-    void ConsolePanel::Clear()
+    void ConsolePanel::RenderDroppedMessages()
     {
-        log_buffer.clear();
+        using namespace Base::Log;
+
+        u64 total = 0;
+        for (size_t i = 0; i < static_cast<size_t>(Class::Count); i++)
+        {
+            total += GetDroppedMessages(static_cast<Class>(i));
+        }
+        if (total == 0)
+        {
+            return;
+        }
+
+        ImGui::SameLine();
+        ImGui::TextColored(Colors::Warning, "Dropped: %llu", static_cast<unsigned long long>(total));
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::BeginTooltip();
+            ImGui::TextUnformatted("Messages discarded because the log queue was full:");
+            for (size_t i = 0; i < static_cast<size_t>(Class::Count); i++)
+            {
+                const u64 dropped = GetDroppedMessages(static_cast<Class>(i));
+                if (dropped != 0)
+                {
+                    ImGui::Text("%s: %llu", GetLogClassName(static_cast<Class>(i)),
+                                static_cast<unsigned long long>(dropped));
+                }
+            }
+            ImGui::EndTooltip();
+        }
     }
 
-    ImVec4 ConsolePanel::GetLogColor(const std::string &text) const
+    void ConsolePanel::DrainLogs()
     {
-        if (text.find("[ERROR]") != std::string::npos)
+        SCOPED_TRACE("Console::DrainLogs");
+        const auto append = [this](Base::Log::ViewerEntry &entry)
+        { Append(entry.timestamp, entry.logClass, entry.logLevel, entry.message); };
+
+        // Whatever is left over stays in the ring for the next frame
+        const auto start = std::chrono::steady_clock::now();
+        while (Base::Log::ReadViewerEntries(append, DRAIN_CHUNK) == DRAIN_CHUNK &&
+               std::chrono::steady_clock::now() - start < DRAIN_BUDGET)
         {
-            return Colors::Error;
         }
-        else if (text.find("[WARN]") != std::string::npos)
+    }
+
+    void ConsolePanel::AddLog(const std::string &text, Base::Log::Level level)
+    {
+        std::string line = text;
+        Append(std::chrono::microseconds{0}, Base::Log::Class::Log, level, line);
+    }
+
+    void ConsolePanel::Append(std::chrono::microseconds timestamp, Base::Log::Class log_class,
+                              Base::Log::Level level, std::string &text)
+    {
+        if (log_buffer.size() < MAX_LOG_ENTRIES)
         {
-            return Colors::Warning;
+            log_buffer.emplace_back();
         }
-        else if (text.find("[INFO]") != std::string::npos)
+        else
         {
-            return Colors::Info;
+            // Overwrite the oldest line
+            if (!filtered_lines.empty() && filtered_lines.front() == first_line)
+            {
+                filtered_lines.pop_front();
+            }
+            first_line++;
+        }
+
+        LogEntry &entry = log_buffer[next_line % MAX_LOG_ENTRIES];
+        entry.timestamp = timestamp;
+        entry.log_class = log_class;
+        entry.level = level;
+        // Swapping hands the old line's storage back to the log ring for reuse
+        std::swap(entry.text, text);
+
+        if (PassesFilter(entry))
+        {
+            filtered_lines.push_back(next_line);
+        }
+        next_line++;
+    }
+
+    void ConsolePanel::Clear()
+    {
+        log_buffer.clear();
+        filtered_lines.clear();
+        first_line = 0;
+        next_line = 0;
+    }
+
+    bool ConsolePanel::PassesFilter(const LogEntry &entry) const
+    {
+        return static_cast<int>(entry.level) >= min_level &&
+               class_enabled[static_cast<size_t>(entry.log_class)];
+    }
+
+    void ConsolePanel::RebuildFilter()
+    {
+        filtered_lines.clear();
+        for (u64 line = first_line; line < next_line; line++)
+        {
+            if (PassesFilter(log_buffer[line % MAX_LOG_ENTRIES]))
+            {
+                filtered_lines.push_back(line);
+            }
         }
-        else if (text.find("[DEBUG]") != std::string::npos)
+    }
+
+    ImVec4 ConsolePanel::GetLogColor(Base::Log::Level level)
+    {
+        using Base::Log::Level;
+
+        switch (level)
         {
+        case Level::Trace:
+        case Level::Debug:
             return Colors::TextDisabled;
+        case Level::Info:
+            return Colors::Info;
+        case Level::Warning:
+            return Colors::Warning;
+        case Level::Error:
+        case Level::Critical:
+            return Colors::Error;
+        default:
+            return Colors::Text;
         }
-        return Colors::Text;
     }
-}
\ No newline at end of file
+}
@@ -2,6 +2,9 @@
 #pragma once
 
 #include "../Panel.h"
+#include "Base/Logging/Backend.h"
+#include <array>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <deque>
@@ -15,22 +18,44 @@ namespace Pound::GUI
         ConsolePanel();
 
         void Render() override;
-        void AddLog(const std::string &text);
+        void AddLog(const std::string &text, Base::Log::Level level = Base::Log::Level::Info);
         void Clear();
 
     private:
         struct LogEntry
         {
+            std::chrono::microseconds timestamp;
+            Base::Log::Class log_class;
+            Base::Log::Level level;
             std::string text;
-            ImVec4 color;
         };
 
-        std::deque<LogEntry> log_buffer;
+        // Lines retained for display, the oldest ones are overwritten once full
+        static constexpr size_t MAX_LOG_ENTRIES = 1 << 17;
+        // Time spent per frame moving entries out of the log viewer ring, read in chunks of DRAIN_CHUNK
+        static constexpr std::chrono::microseconds DRAIN_BUDGET{1000};
+        static constexpr size_t DRAIN_CHUNK = 1024;
+
+        // Ring of retained lines, line number n lives at n % MAX_LOG_ENTRIES
+        std::vector<LogEntry> log_buffer;
+        u64 first_line = 0;
+        u64 next_line = 0;
+        // Line numbers passing the current filter, the only lines the clipper walks
+        std::deque<u64> filtered_lines;
+
+        std::array<bool, static_cast<size_t>(Base::Log::Class::Count)> class_enabled;
+        int min_level = static_cast<int>(Base::Log::Level::Trace);
         bool auto_scroll = true;
         bool show_timestamps = true;
-        static constexpr size_t MAX_LOG_ENTRIES = 1000;
 
-        ImVec4 GetLogColor(const std::string &text) const;
+        void DrainLogs();
+        void Append(std::chrono::microseconds timestamp, Base::Log::Class log_class,
+                    Base::Log::Level level, std::string &text);
+        bool PassesFilter(const LogEntry &entry) const;
+        void RebuildFilter();
+        void RenderFilters();
+        void RenderDroppedMessages();
+        static ImVec4 GetLogColor(Base::Log::Level level);
     };
-    
+
 } // namespace Pound::GUI
\ No newline at end of file
@@ -1,7 +1,9 @@
 // Copyright 2025 Pound Emulator Project. All rights reserved.
 
 #include "PerformancePanel.h"
+#include "memory/scratch.h"
 #include <algorithm>
+#include <string_view>
 
 namespace Pound::GUI
 {
@@ -54,9 +56,16 @@ namespace Pound::GUI
 
         ImGui::Separator();
 
-        // System info (placeholder)
+        // System info
         ImGui::Text("CPU Usage: %.1f%%", current_data.cpu_usage);
-        ImGui::Text("Memory Usage: %.1f MB", current_data.memory_usage);
+        ImGui::Text("Memory Usage (RSS): %.1f MB", current_data.memory_usage);
+#ifdef POUND_COUNT_ALLOCATIONS
+        ImGui::Text("Heap Allocations/frame: %.1f (GUI thread: %.1f)",
+                    current_data.heap_allocations_per_frame,
+                    current_data.gui_heap_allocations_per_frame);
+#endif
+
+        RenderAllocators();
 
         // Emulation stats
         ImGui::Separator();
@@ -67,6 +76,45 @@ namespace Pound::GUI
         ImGui::End();
     }
 
+    void PerformancePanel::RenderAllocators()
+    {
+        if (allocators.empty() || !ImGui::CollapsingHeader("Allocators", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            return;
+        }
+
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                          ImGuiTableFlags_SizingStretchProp;
+        if (!ImGui::BeginTable("##Allocators", 5, flags))
+        {
+            return;
+        }
+
+        ImGui::TableSetupColumn("Name");
+        ImGui::TableSetupColumn("Live (KB)");
+        ImGui::TableSetupColumn("Peak (KB)");
+        ImGui::TableSetupColumn("Rate (MB/s)");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableHeadersRow();
+
+        for (const AllocatorData& allocator : allocators)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(allocator.stats.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", allocator.stats.live_bytes / 1024.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", allocator.stats.peak_bytes / 1024.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", allocator.rate);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(allocator.stats.allocations));
+        }
+
+        ImGui::EndTable();
+    }
+
     void PerformancePanel::Update()
     {
         frame_count++;
@@ -79,6 +127,38 @@ namespace Pound::GUI
             current_data.fps = frame_count * 1000.0f / duration.count();
             current_data.frame_time = duration.count() / (float)frame_count;
 
+            const float seconds = duration.count() / 1000.0f;
+
+            // Allocation rates are derived from the growth of each allocator's total bytes. The
+            // temporaries live on the scratch arena, reset at the start of the next frame.
+            std::pmr::vector<AllocatorData> updated(Memory::scratch_resource());
+            for (const Memory::AllocStatsSnapshot& stats :
+                 Memory::alloc_stats_snapshot(Memory::scratch_resource()))
+            {
+                AllocatorData data;
+                data.stats = stats;
+                for (const AllocatorData& old : allocators)
+                {
+                    if (std::string_view(old.stats.name) == data.stats.name)
+                    {
+                        data.rate = (data.stats.total_bytes - old.stats.total_bytes) /
+                                    (1024.0f * 1024.0f) / seconds;
+                        break;
+                    }
+                }
+                updated.push_back(data);
+            }
+            allocators.assign(updated.begin(), updated.end());
+
+            const Memory::HeapCounters heap = Memory::heap_counters();
+            const Memory::HeapCounters gui_heap = Memory::heap_thread_counters();
+            current_data.heap_allocations_per_frame =
+                (heap.allocations - last_heap.allocations) / (float)frame_count;
+            current_data.gui_heap_allocations_per_frame =
+                (gui_heap.allocations - last_gui_heap.allocations) / (float)frame_count;
+            last_heap = heap;
+            last_gui_heap = gui_heap;
+
             fps_history.push_back(current_data.fps);
             frame_time_history.push_back(current_data.frame_time);
 
@@ -95,9 +175,9 @@ namespace Pound::GUI
             frame_count = 0;
             last_update = now;
 
-            // TODO: Get actual CPU and memory usage
+            // TODO: Get actual CPU usage
             current_data.cpu_usage = 0.0f;
-            current_data.memory_usage = 0.0f;
+            current_data.memory_usage = Memory::process_resident_bytes() / (1024.0f * 1024.0f);
         }
     }
 
@@ -2,8 +2,10 @@
 #pragma once
 
 #include "../Panel.h"
+#include "memory/stats.h"
 #include <deque>
 #include <chrono>
+#include <vector>
 
 namespace Pound::GUI
 {
@@ -23,9 +25,22 @@ namespace Pound::GUI
             float frame_time = 0.0f;
             float cpu_usage = 0.0f;
             float memory_usage = 0.0f;
+            float heap_allocations_per_frame = 0.0f;
+            float gui_heap_allocations_per_frame = 0.0f;
         };
 
+        struct AllocatorData
+        {
+            Memory::AllocStatsSnapshot stats;
+            float rate = 0.0f; // MB/s allocated over the last update interval
+        };
+
+        void RenderAllocators();
+
         PerformanceData current_data;
+        std::vector<AllocatorData> allocators;
+        Memory::HeapCounters last_heap = {};
+        Memory::HeapCounters last_gui_heap = {};
         std::deque<float> fps_history;
         std::deque<float> frame_time_history;
         static constexpr size_t HISTORY_SIZE = 120;
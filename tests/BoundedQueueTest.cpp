@@ -0,0 +1,100 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Base/BoundedQueue.h"
+
+namespace {
+
+constexpr size_t Capacity = 16;
+using Queue = Base::MPSCQueue<int, Capacity>;
+
+int failures = 0;
+
+void Check(bool condition, const char *what) {
+  if (!condition) {
+    fmt::print(stderr, "FAILED: {}\n", what);
+    failures++;
+  }
+}
+
+// With the consumer idle, a push into a full ring evicts exactly the oldest element.
+void OverwriteEvictsOldest() {
+  Queue queue;
+  for (int i = 0; i < static_cast<int>(Capacity); i++) {
+    queue.TryEmplace(i);
+  }
+  std::vector<int> evicted;
+  Check(queue.EmplaceOverwrite([&evicted](int value) { evicted.push_back(value); },
+                               static_cast<int>(Capacity)),
+        "overwrite into a full ring pushes");
+  Check(evicted == std::vector<int>{ 0 }, "only the oldest element is evicted");
+
+  std::vector<int> consumed;
+  queue.ConsumeBatch([&consumed](int value) { consumed.push_back(value); }, Capacity * 2);
+  Check(consumed.size() == Capacity && consumed.front() == 1 &&
+          consumed.back() == static_cast<int>(Capacity),
+        "the ring holds the newest elements in order");
+}
+
+// While the consumer holds the oldest slot, a push drops the new element instead of emptying
+// the ring or waiting for the consumer.
+void OverwriteWithStalledConsumer() {
+  Queue queue;
+  for (int i = 0; i < static_cast<int>(Capacity); i++) {
+    queue.TryEmplace(i);
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stalled = false;
+  bool release = false;
+  std::vector<int> consumed;
+  std::thread consumer([&] {
+    queue.ConsumeBatch([&](int value) {
+      consumed.push_back(value);
+      if (value == 0) {
+        std::unique_lock lock{mutex};
+        stalled = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return release; });
+      }
+    }, Capacity);
+  });
+  {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return stalled; });
+  }
+
+  size_t evicted = 0;
+  Check(!queue.EmplaceOverwrite([&evicted](int) { evicted++; }, 100),
+        "overwrite drops the new element while the oldest slot is held");
+  Check(evicted == 0, "nothing is evicted while the oldest slot is held");
+
+  {
+    std::scoped_lock lock{mutex};
+    release = true;
+  }
+  cv.notify_all();
+  consumer.join();
+  Check(consumed.size() == Capacity, "every queued element reaches the consumer");
+
+  // Once the slot is released overwriting works again, and there is room now
+  Check(queue.EmplaceOverwrite([&evicted](int) { evicted++; }, 101) && evicted == 0,
+        "overwrite pushes once the consumer released the slot");
+}
+
+} // namespace
+
+int main() {
+  OverwriteEvictsOldest();
+  OverwriteWithStalledConsumer();
+  if (failures != 0) {
+    return 1;
+  }
+  fmt::print("All BoundedQueue tests passed\n");
+  return 0;
+}
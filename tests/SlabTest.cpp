@@ -0,0 +1,148 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "memory/slab.h"
+#include "memory/stats.h"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        fmt::print(stderr, "FAILED: {}\n", what);
+        failures++;
+    }
+}
+
+// Every test uses a class of its own with only a few objects per page, so emptying a page and
+// adopting a cache are easy to trigger and no test sees another's caches.
+struct TestClass {
+    Memory::SlabClass* slab_class;
+    std::size_t per_page;
+
+    explicit TestClass(std::size_t size)
+        : slab_class(Memory::slab_class_get(size, 16)), per_page((SLAB_PAGE_SIZE - 16) / size) {}
+
+    std::vector<void*> allocate_page() const {
+        std::vector<void*> objects;
+        for (std::size_t i = 0; i < per_page; i++) {
+            objects.push_back(Memory::slab_allocate(slab_class));
+        }
+        std::sort(objects.begin(), objects.end());
+        return objects;
+    }
+};
+
+// Objects freed by another thread go back to the owner once that thread flushes, even when
+// they don't fill a batch, and the owner reuses them before carving a new page.
+void remote_free_returns_to_owner() {
+    const TestClass test(16384);
+    std::vector<void*> first;
+    std::vector<void*> second;
+    std::atomic<bool> freed = false;
+    std::atomic<bool> reused = false;
+    std::thread owner([&] {
+        first = test.allocate_page();
+        // Stays alive until the owner is done, so only the explicit flush can hand them back
+        std::thread remote([&] {
+            for (void* object : first) {
+                Memory::slab_free(object);
+            }
+            Memory::slab_flush_remote();
+            freed = true;
+            freed.notify_one();
+            reused.wait(false);
+        });
+        freed.wait(false);
+        second = test.allocate_page();
+        reused = true;
+        reused.notify_one();
+        remote.join();
+    });
+    owner.join();
+    check(!first.empty() && first.size() == test.per_page, "a page of objects is allocated");
+    check(second == first, "the owner reuses objects freed by another thread");
+}
+
+// The caches of an exited thread are adopted together with the objects still in them, and
+// objects the exited thread carved are local frees for the adopter.
+void exited_thread_cache_is_adopted() {
+    const TestClass test(16000);
+    std::vector<void*> carved;
+    std::thread([&] {
+        carved = test.allocate_page();
+        Memory::slab_free(carved.front());
+    }).join();
+
+    std::thread([&] {
+        check(Memory::slab_allocate(test.slab_class) == carved.front(),
+              "the adopter gets the object the exited thread freed");
+        for (void* object : carved) {
+            Memory::slab_free(object);
+        }
+        check(test.allocate_page() == carved, "frees into the adopted cache are reused");
+    }).join();
+}
+
+// Slab calls from thread_local destructors running after the thread's caches were released
+// must not touch a cache another thread may have adopted.
+void calls_after_teardown() {
+    const TestClass test(15872);
+    std::vector<void*> carved;
+    void* late_object = nullptr;
+
+    struct Late {
+        const TestClass* test = nullptr;
+        std::vector<void*>* carved = nullptr;
+        void** late_object = nullptr;
+
+        ~Late() {
+            for (void* object : *carved) {
+                Memory::slab_free(object);
+            }
+            *late_object = Memory::slab_allocate(test->slab_class);
+        }
+    };
+
+    std::thread([&] {
+        // Constructed before the slab caches, so destroyed after them
+        thread_local Late late;
+        late.test = &test;
+        late.carved = &carved;
+        late.late_object = &late_object;
+        carved = test.allocate_page();
+    }).join();
+    check(late_object != nullptr, "allocating after teardown works");
+    // Work done after teardown is reported right away, only the late object is still live
+    check(Memory::alloc_stats_get("slab 15872")->live_bytes == 15872,
+          "calls after teardown are reported to the class stats");
+
+    std::thread([&] {
+        std::vector<void*> reused;
+        for (std::size_t i = 0; i < carved.size() - 1; i++) {
+            reused.push_back(Memory::slab_allocate(test.slab_class));
+        }
+        Memory::slab_free(late_object);
+        reused.push_back(Memory::slab_allocate(test.slab_class));
+        std::sort(reused.begin(), reused.end());
+        check(reused == carved, "objects freed after teardown are reclaimed by the adopter");
+    }).join();
+}
+
+}  // namespace
+
+int main() {
+    remote_free_returns_to_owner();
+    exited_thread_cache_is_adopted();
+    calls_after_teardown();
+    if (failures != 0) {
+        return 1;
+    }
+    fmt::print("All slab tests passed\n");
+    return 0;
+}
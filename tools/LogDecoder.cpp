@@ -0,0 +1,203 @@
+// Copyright 2025 Pound Emulator Project. All rights reserved.
+
+// Converts binary .plog files (see core/Base/Logging/BinaryLog.h) to the text log format.
+//
+// Usage: PoundLogDecoder [-v] <input.plog> [output.txt]
+//   -v  Prefix every message with its timestamp and callsite
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Base/Logging/BinaryLog.h"
+
+using namespace Base::Log;
+
+namespace {
+
+struct Callsite {
+  u64 lineNum = 0;
+  std::string format;
+  std::string filename;
+  std::string function;
+};
+
+struct Decoder {
+  std::vector<std::string> classNames;
+  std::vector<std::string> levelNames;
+  std::vector<Callsite> callsites;
+  BinaryLog::ArgStore store;
+  ArgBuffer args;
+  s64 timestamp = 0;
+  bool verbose = false;
+
+  const std::string &Name(const std::vector<std::string> &names, u8 index) const {
+    static const std::string unknown = "Unknown";
+    return index < names.size() ? names[index] : unknown;
+  }
+
+  bool ReadHeader(BinaryLog::Reader &reader) {
+    std::span<const u8> magic;
+    u8 version = 0;
+    if (!reader.ReadBytes(BinaryLog::Magic.size(), magic) ||
+        std::string_view(reinterpret_cast<const char*>(magic.data()), magic.size()) !=
+          BinaryLog::Magic) {
+      fmt::print(stderr, "Not a binary log file\n");
+      return false;
+    }
+    if (!reader.ReadByte(version) || version != BinaryLog::Version) {
+      fmt::print(stderr, "Unsupported binary log version {}\n", version);
+      return false;
+    }
+    for (std::vector<std::string> *names : { &classNames, &levelNames }) {
+      u64 count = 0;
+      if (!reader.ReadVarint(count)) {
+        return false;
+      }
+      names->resize(count);
+      for (std::string &name : *names) {
+        if (!reader.ReadString(name)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void Print(std::string &out, u8 logClass, u8 logLevel, const Callsite *callsite,
+             std::string_view message) const {
+    if (verbose) {
+      fmt::format_to(std::back_inserter(out), "[{:>12.6f}] ", timestamp / 1000000.0);
+    }
+    fmt::format_to(std::back_inserter(out), "[{}] <{}> ", Name(classNames, logClass),
+                   Name(levelNames, logLevel));
+    if (verbose && callsite) {
+      fmt::format_to(std::back_inserter(out), "{}:{}:{}: ", callsite->filename,
+                     callsite->function, callsite->lineNum);
+    }
+    out.append(message);
+    out.push_back('\n');
+  }
+
+  // Decodes one record into `out`, returns false at the end of the data or on corruption
+  bool ReadRecord(BinaryLog::Reader &reader, std::string &out) {
+    u8 type = 0;
+    if (!reader.ReadByte(type)) {
+      return false;
+    }
+    switch (static_cast<BinaryLog::RecordType>(type)) {
+    case BinaryLog::RecordType::Callsite: {
+      u64 id = 0;
+      Callsite callsite;
+      if (!reader.ReadVarint(id) || !reader.ReadVarint(callsite.lineNum) ||
+          !reader.ReadString(callsite.format) || !reader.ReadString(callsite.filename) ||
+          !reader.ReadString(callsite.function) || id != callsites.size()) {
+        return false;
+      }
+      callsites.push_back(std::move(callsite));
+      return true;
+    }
+    case BinaryLog::RecordType::Message: {
+      s64 delta = 0;
+      u8 logClass = 0, logLevel = 0;
+      u64 id = 0, size = 0;
+      if (!reader.ReadSignedVarint(delta) || !reader.ReadByte(logClass) ||
+          !reader.ReadByte(logLevel) || !reader.ReadVarint(id) || !reader.ReadVarint(size) ||
+          !BinaryLog::ReadArgs(reader, size, args) || id >= callsites.size()) {
+        return false;
+      }
+      timestamp += delta;
+      const Callsite &callsite = callsites[id];
+      std::string message;
+      try {
+        if (!BinaryLog::FormatArgs(message, callsite.format.c_str(),
+                                   std::span<const u8>(args.data.data(), args.size), store)) {
+          return false;
+        }
+      } catch (const fmt::format_error &e) {
+        message = fmt::format("Invalid log format \"{}\": {}", callsite.format, e.what());
+      }
+      Print(out, logClass, logLevel, &callsite, message);
+      return true;
+    }
+    case BinaryLog::RecordType::Text: {
+      s64 delta = 0;
+      u8 logClass = 0, logLevel = 0, formatted = 0;
+      std::string message;
+      if (!reader.ReadSignedVarint(delta) || !reader.ReadByte(logClass) ||
+          !reader.ReadByte(logLevel) || !reader.ReadByte(formatted) ||
+          !reader.ReadString(message)) {
+        return false;
+      }
+      timestamp += delta;
+      if (formatted) {
+        Print(out, logClass, logLevel, nullptr, message);
+      } else {
+        out.append(message);
+      }
+      return true;
+    }
+    }
+    return false;
+  }
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Decoder decoder;
+  std::vector<std::string_view> paths;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    if (arg == "-v") {
+      decoder.verbose = true;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty() || paths.size() > 2) {
+    fmt::print(stderr, "Usage: {} [-v] <input.plog> [output.txt]\n", argv[0]);
+    return 1;
+  }
+
+  std::ifstream input(std::string(paths[0]), std::ios::binary);
+  if (!input) {
+    fmt::print(stderr, "Failed to open {}\n", paths[0]);
+    return 1;
+  }
+  const std::vector<u8> data{ std::istreambuf_iterator<char>(input), {} };
+
+  std::FILE *output = stdout;
+  if (paths.size() == 2) {
+    output = std::fopen(std::string(paths[1]).c_str(), "w");
+    if (!output) {
+      fmt::print(stderr, "Failed to open {}\n", paths[1]);
+      return 1;
+    }
+  }
+
+  BinaryLog::Reader reader(data);
+  if (!decoder.ReadHeader(reader)) {
+    return 1;
+  }
+  std::string text;
+  while (!reader.AtEnd()) {
+    if (!decoder.ReadRecord(reader, text)) {
+      fmt::print(stderr, "Log is truncated or corrupted, stopping\n");
+      break;
+    }
+    if (text.size() >= 1_MB) {
+      std::fwrite(text.data(), 1, text.size(), output);
+      text.clear();
+    }
+  }
+  std::fwrite(text.data(), 1, text.size(), output);
+
+  if (output != stdout) {
+    std::fclose(output);
+  }
+  return 0;
+}